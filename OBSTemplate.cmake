@@ -41,6 +41,16 @@ if(NOT BUILD_LOADER)
             "source/json-rpc.cpp"
             "source/server.hpp"
             "source/server.cpp"
+            "source/call-state.hpp"
+            "source/call-state.cpp"
+            "source/dispatch-table.hpp"
+            "source/event-ring.hpp"
+            "source/event-ring.cpp"
+            "source/metrics.hpp"
+            "source/metrics.cpp"
+            "source/mpsc-queue.hpp"
+            "source/param-schema.hpp"
+            "source/param-schema.cpp"
             "source/handlers/handler-system.hpp"
             "source/handlers/handler-system.cpp"
             "source/handlers/handler-obs-frontend.hpp"
@@ -49,6 +59,8 @@ if(NOT BUILD_LOADER)
             "source/handlers/handler-obs-source.cpp"
             "source/handlers/handler-obs-scene.hpp"
             "source/handlers/handler-obs-scene.cpp"
+            "source/handlers/source-metadata.hpp"
+            "source/handlers/source-metadata.cpp"
             "source/details-popup.cpp"
             "source/details-popup.hpp"
             "${PROJECT_BINARY_DIR}/generated/module.cpp"
@@ -80,6 +92,21 @@ if(NOT BUILD_LOADER)
     find_package(obs-frontend-api REQUIRED)
     target_link_libraries(${CMAKE_PROJECT_NAME} PRIVATE OBS::obs-frontend-api)
 
+    # Optional: permessage-deflate compression for WebSocket clients.
+    find_package(ZLIB)
+    if(ZLIB_FOUND)
+        target_compile_definitions(${CMAKE_PROJECT_NAME} PRIVATE ENABLE_PERMESSAGE_DEFLATE)
+        target_link_libraries(${CMAKE_PROJECT_NAME} PRIVATE ZLIB::ZLIB)
+    endif()
+
+    # shm_open() lives in librt on older glibc versions.
+    if(UNIX AND NOT APPLE)
+        find_library(RT_LIBRARY rt)
+        if(RT_LIBRARY)
+            target_link_libraries(${CMAKE_PROJECT_NAME} PRIVATE ${RT_LIBRARY})
+        endif()
+    endif()
+
     find_qt(COMPONENTS Widgets Core)
     target_link_libraries(${CMAKE_PROJECT_NAME} PRIVATE Qt::Core Qt::Widgets)
     set_target_properties(${CMAKE_PROJECT_NAME} PROPERTIES
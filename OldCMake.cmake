@@ -572,6 +572,27 @@ if(NOT BUILD_LOADER)
 		)
 	endif()
 
+	# zlib (Optional, for permessage-deflate)
+	find_package(ZLIB)
+	if(ZLIB_FOUND)
+		list(APPEND PROJECT_LIBRARIES
+			ZLIB::ZLIB
+		)
+		list(APPEND PROJECT_DEFINITIONS
+			-DENABLE_PERMESSAGE_DEFLATE
+		)
+	endif()
+
+	# librt (shm_open on older glibc versions)
+	if(D_PLATFORM_LINUX)
+		find_library(RT_LIBRARY rt)
+		if(RT_LIBRARY)
+			list(APPEND PROJECT_LIBRARIES
+				${RT_LIBRARY}
+			)
+		endif()
+	endif()
+
 	# Project itself
 	list(APPEND PROJECT_PRIVATE_SOURCE
 		"source/module.hpp"
@@ -580,6 +601,16 @@ if(NOT BUILD_LOADER)
 		"source/json-rpc.cpp"
 		"source/server.hpp"
 		"source/server.cpp"
+		"source/call-state.hpp"
+		"source/call-state.cpp"
+		"source/dispatch-table.hpp"
+		"source/event-ring.hpp"
+		"source/event-ring.cpp"
+		"source/metrics.hpp"
+		"source/metrics.cpp"
+		"source/mpsc-queue.hpp"
+		"source/param-schema.hpp"
+		"source/param-schema.cpp"
 		"source/handlers/handler-system.hpp"
 		"source/handlers/handler-system.cpp"
 		"source/handlers/handler-obs-frontend.hpp"
@@ -588,6 +619,8 @@ if(NOT BUILD_LOADER)
 		"source/handlers/handler-obs-source.cpp"
 		"source/handlers/handler-obs-scene.hpp"
 		"source/handlers/handler-obs-scene.cpp"
+		"source/handlers/source-metadata.hpp"
+		"source/handlers/source-metadata.cpp"
 	)
 	list(APPEND PROJECT_INCLUDE_DIRS
 		"${PROJECT_BINARY_DIR}/generated"
@@ -0,0 +1,83 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "call-state.hpp"
+
+static thread_local const streamdeck::call_scope* _current_scope = nullptr;
+
+streamdeck::call_state::call_state(std::weak_ptr<void> handle, std::chrono::steady_clock::time_point deadline)
+	: _handle(std::move(handle)), _deadline(deadline), _finished(false), _timer_lock(), _cancel_timer()
+{}
+
+std::chrono::steady_clock::time_point streamdeck::call_state::deadline() const
+{
+	return _deadline;
+}
+
+bool streamdeck::call_state::cancelled() const
+{
+	return _finished.load(std::memory_order_acquire) || _handle.expired()
+		   || (std::chrono::steady_clock::now() >= _deadline);
+}
+
+bool streamdeck::call_state::finish()
+{
+	if (_finished.exchange(true, std::memory_order_acq_rel)) {
+		return false;
+	}
+
+	std::function<void()> cancel;
+	{
+		std::unique_lock<std::mutex> lock(_timer_lock);
+		cancel.swap(_cancel_timer);
+	}
+	if (cancel) {
+		cancel();
+	}
+	return true;
+}
+
+void streamdeck::call_state::set_timer(std::function<void()> cancel)
+{
+	{
+		std::unique_lock<std::mutex> lock(_timer_lock);
+		if (!_finished.load(std::memory_order_acquire)) {
+			_cancel_timer = std::move(cancel);
+			return;
+		}
+	}
+	cancel();
+}
+
+streamdeck::call_scope::~call_scope()
+{
+	_current_scope = _previous;
+}
+
+streamdeck::call_scope::call_scope(std::shared_ptr<call_state> state)
+	: _state(std::move(state)), _previous(_current_scope)
+{
+	_current_scope = this;
+}
+
+const std::shared_ptr<streamdeck::call_state>& streamdeck::call_scope::state() const
+{
+	return _state;
+}
+
+const streamdeck::call_scope* streamdeck::call_scope::current()
+{
+	return _current_scope;
+}
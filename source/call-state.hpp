@@ -0,0 +1,71 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace streamdeck {
+	// Shared by an asynchronous call, the tasks its handler queued and the eventual reply.
+	//
+	// Whoever finishes the call first answers it: either the handler with its reply, or the server once the deadline
+	// has passed. Tasks queued for a call that can no longer be answered are skipped instead of being run.
+	class call_state {
+		std::weak_ptr<void>                   _handle;
+		std::chrono::steady_clock::time_point _deadline; // time_point::max() if the request didn't set one.
+		std::atomic<bool>                     _finished;
+		std::mutex                            _timer_lock;
+		std::function<void()>                 _cancel_timer; // Cancels the timer answering the call at the deadline.
+
+		public:
+		call_state(std::weak_ptr<void> handle, std::chrono::steady_clock::time_point deadline);
+
+		call_state(const call_state&) = delete;
+		call_state& operator=(const call_state&) = delete;
+
+		std::chrono::steady_clock::time_point deadline() const;
+
+		// Answered already, the connection is gone, or the deadline has passed.
+		bool cancelled() const;
+
+		// Claim the right to answer the call, returns false if somebody else already did. Cancels the deadline timer,
+		// so that it doesn't hold on to the call until the deadline.
+		bool finish();
+
+		// Set along with the deadline timer, called once the call is finished. Called right away if it already is.
+		void set_timer(std::function<void()> cancel);
+	};
+
+	// Marks the call a thread is currently working on, like metrics_scope does for its method.
+	class call_scope {
+		std::shared_ptr<call_state> _state;
+		const call_scope*           _previous;
+
+		public:
+		~call_scope();
+		call_scope(std::shared_ptr<call_state> state);
+
+		call_scope(const call_scope&) = delete;
+		call_scope& operator=(const call_scope&) = delete;
+
+		const std::shared_ptr<call_state>& state() const;
+
+		// The innermost scope on this thread, or nullptr.
+		static const call_scope* current();
+	};
+} // namespace streamdeck
@@ -0,0 +1,141 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace streamdeck {
+	// String keyed table which is filled once, then frozen and only ever read.
+	//
+	// insert() may only be called before freeze(), and is not thread-safe. Once frozen, the entries are laid out in a
+	// flat open-addressing table (FNV-1a, linear probing, at most half full), and find() is a lock-free lookup that
+	// may be called from any number of threads.
+	template<typename T>
+	class dispatch_table {
+		struct entry {
+			std::string key;
+			uint64_t    hash;
+			T           value;
+		};
+
+		std::vector<entry>  _entries; // Insertion order, until frozen.
+		std::vector<size_t> _slots;   // Index into _entries plus one, zero marks an empty slot.
+		size_t              _mask;
+		std::atomic<bool>   _frozen;
+
+		static uint64_t hash(std::string_view key)
+		{
+			uint64_t value = 14695981039346656037ull;
+			for (char c : key) {
+				value ^= static_cast<uint8_t>(c);
+				value *= 1099511628211ull;
+			}
+			return value;
+		}
+
+		public:
+		dispatch_table() : _entries(), _slots(), _mask(0), _frozen(false) {}
+
+		dispatch_table(const dispatch_table&) = delete;
+		dispatch_table& operator=(const dispatch_table&) = delete;
+
+		// Add an entry, returns false if the key is already present. The first value for a key wins.
+		bool insert(std::string key, T value)
+		{
+			if (_frozen.load(std::memory_order_relaxed)) {
+				throw std::logic_error("Dispatch table is already frozen.");
+			}
+
+			uint64_t key_hash = hash(key);
+			for (auto const& kv : _entries) {
+				if ((kv.hash == key_hash) && (kv.key == key)) {
+					return false;
+				}
+			}
+			_entries.push_back({std::move(key), key_hash, std::move(value)});
+			return true;
+		}
+
+		void freeze()
+		{
+			if (_frozen.load(std::memory_order_relaxed)) {
+				return;
+			}
+
+			size_t capacity = 8;
+			while (capacity < (_entries.size() * 2)) {
+				capacity *= 2;
+			}
+			_mask = capacity - 1;
+			_slots.assign(capacity, 0);
+			for (size_t idx = 0; idx < _entries.size(); idx++) {
+				size_t slot = static_cast<size_t>(_entries[idx].hash) & _mask;
+				while (_slots[slot] != 0) {
+					slot = (slot + 1) & _mask;
+				}
+				_slots[slot] = idx + 1;
+			}
+
+			// Publish the finished table to readers on other threads.
+			_frozen.store(true, std::memory_order_release);
+		}
+
+		bool frozen() const
+		{
+			return _frozen.load(std::memory_order_acquire);
+		}
+
+		// Look up a key, returns nullptr if it is unknown or the table isn't frozen yet.
+		const T* find(std::string_view key) const
+		{
+			if (!_frozen.load(std::memory_order_acquire)) {
+				return nullptr;
+			}
+
+			uint64_t key_hash = hash(key);
+			for (size_t slot = static_cast<size_t>(key_hash) & _mask;; slot = (slot + 1) & _mask) {
+				size_t idx = _slots[slot];
+				if (idx == 0) {
+					return nullptr;
+				}
+				auto const& kv = _entries[idx - 1];
+				if ((kv.hash == key_hash) && (kv.key == key)) {
+					return &kv.value;
+				}
+			}
+		}
+
+		size_t size() const
+		{
+			return _entries.size();
+		}
+
+		// Visit every entry in insertion order, as func(key, value).
+		template<typename F>
+		void for_each(F&& func) const
+		{
+			for (auto const& kv : _entries) {
+				func(kv.key, kv.value);
+			}
+		}
+	};
+} // namespace streamdeck
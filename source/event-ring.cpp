@@ -0,0 +1,149 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "event-ring.hpp"
+
+#ifdef HAVE_EVENT_RING
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static size_t align_record(size_t size)
+{
+	return (size + 7) & ~size_t(7);
+}
+
+streamdeck::event_ring::~event_ring()
+{
+	if (_memory) {
+		munmap(_memory, _size);
+	}
+	if (_fd != -1) {
+		close(_fd);
+		shm_unlink(_name.c_str());
+	}
+}
+
+streamdeck::event_ring::event_ring(std::string name, size_t capacity)
+	: _name(std::move(name)), _fd(-1), _size(0), _memory(nullptr), _header(nullptr), _data(nullptr), _position(0)
+{
+	size_t actual = 4096;
+	while (actual < capacity) {
+		actual *= 2;
+	}
+	_size = sizeof(header) + actual;
+
+	// Left behind by a crashed instance with the same process id.
+	shm_unlink(_name.c_str());
+
+	try {
+		_fd = shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+		if (_fd == -1) {
+			throw std::runtime_error(std::string("shm_open: ") + strerror(errno));
+		}
+		if (ftruncate(_fd, static_cast<off_t>(_size)) != 0) {
+			throw std::runtime_error(std::string("ftruncate: ") + strerror(errno));
+		}
+
+		void* memory = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+		if (memory == MAP_FAILED) {
+			throw std::runtime_error(std::string("mmap: ") + strerror(errno));
+		}
+		_memory = static_cast<uint8_t*>(memory);
+		_data   = _memory + sizeof(header);
+	} catch (...) {
+		if (_fd != -1) {
+			close(_fd);
+			shm_unlink(_name.c_str());
+		}
+		throw;
+	}
+
+	_header              = new (_memory) header();
+	_header->version     = VERSION;
+	_header->header_size = sizeof(header);
+	_header->capacity    = actual;
+	_header->reserved.store(0, std::memory_order_relaxed);
+	_header->committed.store(0, std::memory_order_relaxed);
+	_header->sequence.store(0, std::memory_order_relaxed);
+
+	// Readers wait for the magic before looking at anything else.
+	std::atomic_thread_fence(std::memory_order_release);
+	_header->magic = MAGIC;
+}
+
+const std::string& streamdeck::event_ring::name() const
+{
+	return _name;
+}
+
+size_t streamdeck::event_ring::capacity() const
+{
+	return static_cast<size_t>(_header->capacity);
+}
+
+bool streamdeck::event_ring::write(uint64_t sequence, const std::string& method, const std::vector<uint8_t>& payload)
+{
+	uint64_t capacity = _header->capacity;
+	size_t   size     = align_record(sizeof(record) + method.size() + payload.size());
+	if ((size > (capacity / 2)) || (method.size() > UINT16_MAX)) {
+		return false;
+	}
+
+	// Records never wrap around. If this one doesn't fit before the end, the rest is skipped by readers.
+	size_t offset = static_cast<size_t>(_position & (capacity - 1));
+	size_t tail   = static_cast<size_t>(capacity) - offset;
+	size_t skip   = (tail < size) ? tail : 0;
+
+	// Announce the region about to be overwritten first, so that readers still inside it can tell.
+	_header->reserved.store(_position + skip + size, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	if (skip > 0) {
+		// A tail shorter than a record header is skipped implicitly.
+		if (skip >= sizeof(record)) {
+			record pad{};
+			pad.size = static_cast<uint32_t>(skip);
+			pad.type = PADDING;
+			memcpy(_data + offset, &pad, sizeof(record));
+		}
+		_position += skip;
+		offset = 0;
+	}
+
+	record entry{};
+	entry.size         = static_cast<uint32_t>(size);
+	entry.payload_size = static_cast<uint32_t>(payload.size());
+	entry.sequence     = sequence;
+	entry.method_size  = static_cast<uint16_t>(method.size());
+	entry.type         = EVENT;
+	memcpy(_data + offset, &entry, sizeof(record));
+	memcpy(_data + offset + sizeof(record), method.data(), method.size());
+	if (!payload.empty()) {
+		memcpy(_data + offset + sizeof(record) + method.size(), payload.data(), payload.size());
+	}
+	_position += size;
+
+	_header->sequence.store(sequence, std::memory_order_release);
+	_header->committed.store(_position, std::memory_order_release);
+	return true;
+}
+#endif
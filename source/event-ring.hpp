@@ -0,0 +1,91 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#define HAVE_EVENT_RING
+#endif
+
+#ifdef HAVE_EVENT_RING
+namespace streamdeck {
+	// Notifications mirrored into a POSIX shared memory ring buffer, for readers on the same machine.
+	//
+	// There is a single writer, and any number of readers which never block it. A reader that falls behind by more
+	// than the capacity loses events, and notices through the sequence numbers. See docs/rpc-definition.md for the
+	// layout readers have to follow.
+	class event_ring {
+		public:
+		static constexpr uint32_t MAGIC   = 0x52454453; // "SDER" in little endian.
+		static constexpr uint16_t VERSION = 1;
+
+		enum record_type : uint16_t {
+			PADDING = 0, // Skip to the start of the data area.
+			EVENT   = 1, // Method name followed by the MessagePack encoded params.
+		};
+
+		struct header {
+			uint32_t              magic;
+			uint16_t              version;
+			uint16_t              header_size;
+			uint64_t              capacity;  // Size of the data area following the header, a power of two.
+			std::atomic<uint64_t> reserved;  // End position of the record being written, published before writing.
+			std::atomic<uint64_t> committed; // End position of the last complete record.
+			std::atomic<uint64_t> sequence;  // Sequence number of the last complete record.
+			uint8_t               padding[24];
+		};
+		static_assert(sizeof(header) == 64, "Header layout is part of the reader protocol.");
+
+		struct record {
+			uint32_t size;         // Whole record including this header, a multiple of 8.
+			uint32_t payload_size; // MessagePack bytes following the method name.
+			uint64_t sequence;
+			uint16_t method_size;
+			uint16_t type;
+			uint32_t reserved;
+		};
+		static_assert(sizeof(record) == 24, "Record layout is part of the reader protocol.");
+
+		private:
+		std::string _name;
+		int         _fd;
+		size_t      _size;
+		uint8_t*    _memory;
+		header*     _header;
+		uint8_t*    _data;
+		uint64_t    _position; // Same as _header->committed, but only read and written by the writer.
+
+		public:
+		~event_ring();
+
+		// Create (or replace) the shared memory object. Throws std::runtime_error on failure.
+		event_ring(std::string name, size_t capacity);
+
+		event_ring(const event_ring&) = delete;
+		event_ring& operator=(const event_ring&) = delete;
+
+		const std::string& name() const;
+		size_t             capacity() const;
+
+		// Append an event under the given sequence number, returns false if it doesn't fit into half of the ring.
+		bool write(uint64_t sequence, const std::string& method, const std::vector<uint8_t>& payload);
+	};
+} // namespace streamdeck
+#endif
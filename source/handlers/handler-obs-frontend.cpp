@@ -40,38 +40,14 @@ static std::function<void(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonr
 	// TODO: Make function signature less insane
 
 	return [callback](std::weak_ptr<void> handle, std::shared_ptr<streamdeck::jsonrpc::request> req) {
-		struct passed_data {
-			std::weak_ptr<void>                           handle;
-			std::shared_ptr<streamdeck::jsonrpc::request> req;
-			std::function<void(std::shared_ptr<streamdeck::jsonrpc::request>,
-							   std::shared_ptr<streamdeck::jsonrpc::response>)>
-				callback;
-		};
-		passed_data* pd = new passed_data();
-		pd->handle      = handle;
-		pd->req         = req;
-		pd->callback    = callback;
-
-		obs_queue_task(
-			obs_task_type::OBS_TASK_UI,
-			[](void* ptr) {
-				nlohmann::json params;
-
-				// Retrieve passed things and clean up immediately.
-				passed_data*                                  pd       = static_cast<passed_data*>(ptr);
-				std::weak_ptr<void>                           handle   = pd->handle;
-				std::shared_ptr<streamdeck::jsonrpc::request> req      = pd->req;
-				auto                                          callback = pd->callback;
-				delete pd;
-
-				auto res = std::make_shared<streamdeck::jsonrpc::response>();
-				res->copy_id(*req);
+		streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req, callback]() {
+			auto res = std::make_shared<streamdeck::jsonrpc::response>();
+			res->copy_id(*req);
 
-				callback(req, res);
+			callback(req, res);
 
-				streamdeck::server::instance()->reply(handle, res);
-			},
-			pd, false);
+			streamdeck::server::instance()->reply(handle, res);
+		});
 	};
 }
 
@@ -131,26 +107,29 @@ streamdeck::handlers::obs_frontend::obs_frontend()
 																  this, std::placeholders::_1, std::placeholders::_2));
 	server->handle_sync("obs.frontend.streaming.stop", std::bind(&streamdeck::handlers::obs_frontend::streaming_stop,
 																 this, std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.frontend.streaming.active",
-						std::bind(&streamdeck::handlers::obs_frontend::streaming_active, this, std::placeholders::_1,
-								  std::placeholders::_2));
+	server->handle_query("obs.frontend.streaming.active",
+						 std::bind(&streamdeck::handlers::obs_frontend::streaming_active, this, std::placeholders::_1,
+								   std::placeholders::_2));
+	server->set_watch_triggers("obs.frontend.streaming.active", {"obs.frontend.event.streaming"});
 
 	server->handle_sync("obs.frontend.recording.start", std::bind(&streamdeck::handlers::obs_frontend::recording_start,
 																  this, std::placeholders::_1, std::placeholders::_2));
 	server->handle_sync("obs.frontend.recording.stop", std::bind(&streamdeck::handlers::obs_frontend::recording_stop,
 																 this, std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.frontend.recording.active",
-						std::bind(&streamdeck::handlers::obs_frontend::recording_active, this, std::placeholders::_1,
-								  std::placeholders::_2));
+	server->handle_query("obs.frontend.recording.active",
+						 std::bind(&streamdeck::handlers::obs_frontend::recording_active, this, std::placeholders::_1,
+								   std::placeholders::_2));
+	server->set_watch_triggers("obs.frontend.recording.active", {"obs.frontend.event.recording"});
 
 	server->handle_sync("obs.frontend.recording.pause", std::bind(&streamdeck::handlers::obs_frontend::recording_pause,
 																  this, std::placeholders::_1, std::placeholders::_2));
 	server->handle_sync("obs.frontend.recording.unpause",
 						std::bind(&streamdeck::handlers::obs_frontend::recording_unpause, this, std::placeholders::_1,
 								  std::placeholders::_2));
-	server->handle_sync("obs.frontend.recording.paused",
-						std::bind(&streamdeck::handlers::obs_frontend::recording_paused, this, std::placeholders::_1,
-								  std::placeholders::_2));
+	server->handle_query("obs.frontend.recording.paused",
+						 std::bind(&streamdeck::handlers::obs_frontend::recording_paused, this, std::placeholders::_1,
+								   std::placeholders::_2));
+	server->set_watch_triggers("obs.frontend.recording.paused", {"obs.frontend.event.recording"});
 
 	server->handle_async(
 		"obs.frontend.replaybuffer.enabled",
@@ -173,8 +152,9 @@ streamdeck::handlers::obs_frontend::obs_frontend()
 		make_async(obs_task_type::OBS_TASK_UI, std::bind(&streamdeck::handlers::obs_frontend::replaybuffer_active, this,
 														 std::placeholders::_1, std::placeholders::_2)));
 
-	server->handle_async("obs.frontend.studiomode", std::bind(&streamdeck::handlers::obs_frontend::studiomode, this,
-															  std::placeholders::_1, std::placeholders::_2));
+	server->handle_async(frontend_studiomode_method,
+						 std::bind(&streamdeck::handlers::obs_frontend::studiomode, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3));
 	server->handle_async("obs.frontend.studiomode.enable",
 						 std::bind(&streamdeck::handlers::obs_frontend::studiomode_enable, this, std::placeholders::_1,
 								   std::placeholders::_2));
@@ -201,22 +181,30 @@ streamdeck::handlers::obs_frontend::obs_frontend()
 						 std::bind(&streamdeck::handlers::obs_frontend::transition_studio, this, std::placeholders::_1,
 								   std::placeholders::_2));
 
-	server->handle_async("obs.frontend.scenecollection", std::bind(&streamdeck::handlers::obs_frontend::scenecollection,
-																   this, std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.frontend.scenecollection.list",
-						std::bind(&streamdeck::handlers::obs_frontend::scenecollection_list, this,
-								  std::placeholders::_1, std::placeholders::_2));
-
-	server->handle_async("obs.frontend.profile", std::bind(&streamdeck::handlers::obs_frontend::profile,
-																   this, std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.frontend.profile.list",
-						std::bind(&streamdeck::handlers::obs_frontend::profile_list, this,
-								  std::placeholders::_1, std::placeholders::_2));
+	server->handle_async(frontend_scenecollection_method,
+						 std::bind(&streamdeck::handlers::obs_frontend::scenecollection, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3));
+	server->handle_query("obs.frontend.scenecollection.list",
+						 std::bind(&streamdeck::handlers::obs_frontend::scenecollection_list, this,
+								   std::placeholders::_1, std::placeholders::_2));
+	server->set_watch_triggers("obs.frontend.scenecollection.list",
+							   {"obs.frontend.event.scenecollections", "obs.frontend.event.scenecollection.renamed"});
+
+	server->handle_async(frontend_profile_method,
+						 std::bind(&streamdeck::handlers::obs_frontend::profile, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3));
+	server->handle_query("obs.frontend.profile.list",
+						 std::bind(&streamdeck::handlers::obs_frontend::profile_list, this,
+								   std::placeholders::_1, std::placeholders::_2));
+	server->set_watch_triggers("obs.frontend.profile.list",
+							   {"obs.frontend.event.profiles", "obs.frontend.event.profile.renamed"});
 
-	server->handle_async("obs.frontend.scene", std::bind(&streamdeck::handlers::obs_frontend::scene, this,
-														 std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.frontend.scene.list", std::bind(&streamdeck::handlers::obs_frontend::scene_list, this,
-															 std::placeholders::_1, std::placeholders::_2));
+	server->handle_async(frontend_scene_method,
+						 std::bind(&streamdeck::handlers::obs_frontend::scene, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3));
+	server->handle_query("obs.frontend.scene.list", std::bind(&streamdeck::handlers::obs_frontend::scene_list, this,
+															  std::placeholders::_1, std::placeholders::_2));
+	server->set_watch_triggers("obs.frontend.scene.list", {"obs.frontend.event.scenes"});
 
 	server->handle_async("obs.frontend.transition", std::bind(&streamdeck::handlers::obs_frontend::transition, this,
 															  std::placeholders::_1, std::placeholders::_2));
@@ -226,8 +214,9 @@ streamdeck::handlers::obs_frontend::obs_frontend()
 	server->handle_sync("obs.frontend.screenshot", std::bind(&streamdeck::handlers::obs_frontend::screenshot, this,
 															 std::placeholders::_1, std::placeholders::_2));
 
-	server->handle_sync("obs.frontend.stats", std::bind(&streamdeck::handlers::obs_frontend::stats, this,
-														std::placeholders::_1, std::placeholders::_2));
+	// Runs on the worker only, the frontend API isn't meant to be called from several threads at once.
+	server->handle_query("obs.frontend.stats", std::bind(&streamdeck::handlers::obs_frontend::stats, this,
+														 std::placeholders::_1, std::placeholders::_2));
 
 	server->handle_async("obs.frontend.tbar", std::bind(&streamdeck::handlers::obs_frontend::tbar, this,
 														 std::placeholders::_1, std::placeholders::_2));
@@ -520,7 +509,11 @@ void streamdeck::handlers::obs_frontend::handle(enum obs_frontend_event event)
 
 		}
 
-		streamdeck::server::instance()->notify(method, reply);
+		if (event == OBS_FRONTEND_EVENT_TBAR_VALUE_CHANGED) {
+			streamdeck::server::instance()->notify_coalesced(method, std::string(), reply);
+		} else {
+			streamdeck::server::instance()->notify(method, reply);
+		}
 	} catch (std::exception const& ex) {
 		DLOG(LOG_DEBUG, "Error: %s", ex.what());
 	}
@@ -767,7 +760,8 @@ void streamdeck::handlers::obs_frontend::replaybuffer_active(std::shared_ptr<str
 	res->set_result(obs_frontend_replay_buffer_active());
 }
 
-void streamdeck::handlers::obs_frontend::studiomode(std::weak_ptr<void>                           handle,
+void streamdeck::handlers::obs_frontend::studiomode(const frontend_studiomode_params&             params,
+													std::weak_ptr<void>                           handle,
 													std::shared_ptr<streamdeck::jsonrpc::request> req)
 {
 	/** obs.frontend.studiomode
@@ -777,45 +771,19 @@ void streamdeck::handlers::obs_frontend::studiomode(std::weak_ptr<void>
 	 * @return {bool} `true` if Studio Mode is enabled, otherwise `false`.
 	 */
 
-	struct passed_data {
-		std::weak_ptr<void>                           handle;
-		std::shared_ptr<streamdeck::jsonrpc::request> req;
-	};
-	passed_data* pd = new passed_data();
-	pd->handle      = handle;
-	pd->req         = req;
-
 	// Studio Mode affects UI directly, so we need to perform this in the UI thread.
-	obs_queue_task(
-		obs_task_type::OBS_TASK_UI,
-		[](void* ptr) {
-			nlohmann::json params;
-
-			// Retrieve passed things and clean up immediately.
-			passed_data*                                  pd     = static_cast<passed_data*>(ptr);
-			std::weak_ptr<void>                           handle = pd->handle;
-			std::shared_ptr<streamdeck::jsonrpc::request> req    = pd->req;
-			delete pd;
-
-			// If there was a request to change mode, do it.
-			if (req->get_params(params)) {
-				auto p = params.find("enabled");
-				if (p != params.end()) {
-					if (!p->is_boolean()) {
-						throw jsonrpc::invalid_params_error("Parameter 'enabled' must be a Boolean.");
-					}
-
-					obs_frontend_set_preview_program_mode(p->get<bool>());
-				}
-			}
+	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req, enabled = params.enabled]() {
+		// If there was a request to change mode, do it.
+		if (enabled) {
+			obs_frontend_set_preview_program_mode(*enabled);
+		}
 
-			// Reply with current state.
-			auto res = std::make_shared<streamdeck::jsonrpc::response>();
-			res->copy_id(*req);
-			res->set_result(obs_frontend_preview_program_mode_active());
-			streamdeck::server::instance()->reply(handle, res);
-		},
-		pd, false);
+		// Reply with current state.
+		auto res = std::make_shared<streamdeck::jsonrpc::response>();
+		res->copy_id(*req);
+		res->set_result(obs_frontend_preview_program_mode_active());
+		streamdeck::server::instance()->reply(handle, res);
+	});
 }
 
 void streamdeck::handlers::obs_frontend::studiomode_enable(std::weak_ptr<void>                           handle,
@@ -826,10 +794,9 @@ void streamdeck::handlers::obs_frontend::studiomode_enable(std::weak_ptr<void>
 	 * Alias of obs.frontend.studiomode(enabled=true).
 	 */
 
-	nlohmann::json params;
-	params["enabled"] = true;
-	req->set_params(params);
-	studiomode(handle, req);
+	frontend_studiomode_params params{};
+	params.enabled = true;
+	studiomode(params, handle, req);
 }
 
 void streamdeck::handlers::obs_frontend::studiomode_disable(std::weak_ptr<void>                           handle,
@@ -840,10 +807,9 @@ void streamdeck::handlers::obs_frontend::studiomode_disable(std::weak_ptr<void>
 	 * Alias of obs.frontend.studiomode(enabled=false).
 	 */
 
-	nlohmann::json params;
-	params["enabled"] = false;
-	req->set_params(params);
-	studiomode(handle, req);
+	frontend_studiomode_params params{};
+	params.enabled = false;
+	studiomode(params, handle, req);
 }
 
 void streamdeck::handlers::obs_frontend::studiomode_active(std::weak_ptr<void>                           handle,
@@ -853,7 +819,7 @@ void streamdeck::handlers::obs_frontend::studiomode_active(std::weak_ptr<void>
 	 *
 	 * Alias of obs.frontend.studiomode().
 	 */
-	studiomode(handle, req);
+	studiomode(frontend_studiomode_params{}, handle, req);
 }
 
 
@@ -867,53 +833,36 @@ void streamdeck::handlers::obs_frontend::virtualcam(std::weak_ptr<void>
 	 * @return {bool} `true` if the virtual cam is enabled, otherwise `false`.
 	 */
 
-	struct passed_data {
-		std::weak_ptr<void>                           handle;
-		std::shared_ptr<streamdeck::jsonrpc::request> req;
-	};
-	passed_data* pd = new passed_data();
-	pd->handle      = handle;
-	pd->req         = req;
-
-	obs_queue_task(
-		obs_task_type::OBS_TASK_UI,
-		[](void* ptr) {
-			nlohmann::json params;
-
-			// Retrieve passed things and clean up immediately.
-			passed_data*                                  pd     = static_cast<passed_data*>(ptr);
-			std::weak_ptr<void>                           handle = pd->handle;
-			std::shared_ptr<streamdeck::jsonrpc::request> req    = pd->req;
-			delete pd;
-
-			bool current_state = obs_frontend_virtualcam_active();
-
-			// If there was a request to change mode, do it.
-			if (req->get_params(params)) {
-				auto p = params.find("enabled");
-				if (p != params.end()) {
-					if (!p->is_boolean()) {
-						throw jsonrpc::invalid_params_error("Parameter 'enabled' must be a Boolean.");
-					}
+	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req]() {
+		auto const& params = req->get_params();
+
+		bool current_state = obs_frontend_virtualcam_active();
 
-					auto new_state = p->get<bool>();
-					if (new_state != current_state) {
-						if (new_state) {
-							obs_frontend_start_virtualcam();
-						} else {
-							obs_frontend_stop_virtualcam();
-						}
+		// If there was a request to change mode, do it.
+		if (!params.is_null()) {
+			auto p = params.find("enabled");
+			if (p != params.end()) {
+				if (!p->is_boolean()) {
+					throw jsonrpc::invalid_params_error("Parameter 'enabled' must be a Boolean.");
+				}
+
+				auto new_state = p->get<bool>();
+				if (new_state != current_state) {
+					if (new_state) {
+						obs_frontend_start_virtualcam();
+					} else {
+						obs_frontend_stop_virtualcam();
 					}
 				}
 			}
+		}
 
-			// Reply with current state.
-			auto res = std::make_shared<streamdeck::jsonrpc::response>();
-			res->copy_id(*req);
-			res->set_result(obs_frontend_virtualcam_active());
-			streamdeck::server::instance()->reply(handle, res);
-		},
-		pd, false);
+		// Reply with current state.
+		auto res = std::make_shared<streamdeck::jsonrpc::response>();
+		res->copy_id(*req);
+		res->set_result(obs_frontend_virtualcam_active());
+		streamdeck::server::instance()->reply(handle, res);
+	});
 }
 
 void streamdeck::handlers::obs_frontend::virtualcam_start(std::weak_ptr<void>                           handle,
@@ -962,40 +911,24 @@ void streamdeck::handlers::obs_frontend::transition_studio(std::weak_ptr<void>
 	 * Transitions the "preview" scene into the "program" scene
 	 */
 
-	struct passed_data {
-		std::weak_ptr<void>                           handle;
-		std::shared_ptr<streamdeck::jsonrpc::request> req;
-	};
-	passed_data* pd = new passed_data();
-	pd->handle      = handle;
-	pd->req         = req;
-
-	obs_queue_task(
-		obs_task_type::OBS_TASK_UI,
-		[](void* ptr) {
-			// Retrieve passed things and clean up immediately.
-			passed_data*                                  pd     = static_cast<passed_data*>(ptr);
-			std::weak_ptr<void>                           handle = pd->handle;
-			std::shared_ptr<streamdeck::jsonrpc::request> req    = pd->req;
-			delete pd;
-
-			std::shared_ptr<streamdeck::jsonrpc::response> res = std::make_shared<streamdeck::jsonrpc::response>();
-
-			obs_frontend_preview_program_trigger_transition();
-			res->copy_id(*req);
-			res->set_result("");
+	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req]() {
+		std::shared_ptr<streamdeck::jsonrpc::response> res = std::make_shared<streamdeck::jsonrpc::response>();
 
-			try {
-				res->validate();
-				streamdeck::server::instance()->reply(handle, res);
-			} catch (std::exception const& ex) {
-				DLOG(LOG_ERROR, "Failed to send reply: %s", ex.what());
-			}
-		},
-		pd, false);
+		obs_frontend_preview_program_trigger_transition();
+		res->copy_id(*req);
+		res->set_result("");
+
+		try {
+			res->validate();
+			streamdeck::server::instance()->reply(handle, res);
+		} catch (std::exception const& ex) {
+			DLOG(LOG_ERROR, "Failed to send reply: %s", ex.what());
+		}
+	});
 }
 
-void streamdeck::handlers::obs_frontend::scenecollection(std::weak_ptr<void>                           handle,
+void streamdeck::handlers::obs_frontend::scenecollection(const frontend_scenecollection_params&        params,
+														 std::weak_ptr<void>                           handle,
 														 std::shared_ptr<streamdeck::jsonrpc::request> req)
 {
 	/** obs.frontend.scenecollection
@@ -1005,64 +938,27 @@ void streamdeck::handlers::obs_frontend::scenecollection(std::weak_ptr<void>
 	 * @return {string} The name of the current scene collection.
 	 */
 
-	// Validate parameters.
-	nlohmann::json params;
-	if (req->get_params(params)) {
-		auto p = params.find("collection");
-		if (p != params.end()) {
-			if (!p->is_string()) {
-				throw jsonrpc::invalid_params_error("Parameter 'collection' must be a string or String.");
-			}
-		}
-	}
-
-	struct passed_data {
-		std::weak_ptr<void>                           handle;
-		std::shared_ptr<streamdeck::jsonrpc::request> req;
-	};
-	passed_data* pd = new passed_data();
-	pd->handle      = handle;
-	pd->req         = req;
-
 	// Some Frontend interaction requires a frontend task.
-	obs_queue_task(
-		obs_task_type::OBS_TASK_UI,
-		[](void* ptr) {
-			// Retrieve passed things and clean up immediately.
-			passed_data*                                  pd     = static_cast<passed_data*>(ptr);
-			std::weak_ptr<void>                           handle = pd->handle;
-			std::shared_ptr<streamdeck::jsonrpc::request> req    = pd->req;
-			delete pd;
-
-			std::shared_ptr<streamdeck::jsonrpc::response> res = std::make_shared<streamdeck::jsonrpc::response>();
-			res->copy_id(*req);
-			try {
-				nlohmann::json params;
-				req->get_params(params);
-				if (params.size() > 0) {
-					auto kv = params.find("collection");
-					if ((kv != params.end()) && (kv->is_string())) {
-						std::string collection;
-						kv->get_to(collection);
-						obs_frontend_set_current_scene_collection(collection.c_str());
-					} else {
-						throw streamdeck::jsonrpc::invalid_params_error("'collection' must be a string value.");
-					}
-				}
-
-				const char* col = obs_frontend_get_current_scene_collection();
-				res->set_result(col ? col : "");
-			} catch (streamdeck::jsonrpc::error const& ex) {
-				res->set_error(ex.id(), ex.what() ? ex.what() : "Unknown error.");
-			}
-			try {
-				res->validate();
-				streamdeck::server::instance()->reply(handle, res);
-			} catch (std::exception const& ex) {
-				DLOG(LOG_ERROR, "Failed to send reply: %s", ex.what());
+	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req, collection = params.collection]() {
+		std::shared_ptr<streamdeck::jsonrpc::response> res = std::make_shared<streamdeck::jsonrpc::response>();
+		res->copy_id(*req);
+		try {
+			if (collection) {
+				obs_frontend_set_current_scene_collection(collection->c_str());
 			}
-		},
-		pd, false);
+
+			const char* col = obs_frontend_get_current_scene_collection();
+			res->set_result(col ? col : "");
+		} catch (streamdeck::jsonrpc::error const& ex) {
+			res->set_error(ex.id(), ex.what() ? ex.what() : "Unknown error.");
+		}
+		try {
+			res->validate();
+			streamdeck::server::instance()->reply(handle, res);
+		} catch (std::exception const& ex) {
+			DLOG(LOG_ERROR, "Failed to send reply: %s", ex.what());
+		}
+	});
 }
 
 void streamdeck::handlers::obs_frontend::scenecollection_list(std::shared_ptr<streamdeck::jsonrpc::request>,
@@ -1081,11 +977,12 @@ void streamdeck::handlers::obs_frontend::scenecollection_list(std::shared_ptr<st
 	}
 	bfree(list);
 
-	res->set_result(collections);
+	res->set_result(std::move(collections));
 }
 
 
-void streamdeck::handlers::obs_frontend::profile(std::weak_ptr<void>                           handle,
+void streamdeck::handlers::obs_frontend::profile(const frontend_profile_params&                params,
+														 std::weak_ptr<void>                           handle,
 														 std::shared_ptr<streamdeck::jsonrpc::request> req)
 {
 	/** obs.frontend.profile
@@ -1095,65 +992,28 @@ void streamdeck::handlers::obs_frontend::profile(std::weak_ptr<void>
 	 * @return {string} The name of the current profile.
 	 */
 
-	// Validate parameters.
-	nlohmann::json params;
-	if (req->get_params(params)) {
-		auto p = params.find("profile");
-		if (p != params.end()) {
-			if (!p->is_string()) {
-				throw jsonrpc::invalid_params_error("Parameter 'profile' must be a string or String.");
-			}
-		}
-	}
-
-	struct passed_data {
-		std::weak_ptr<void>                           handle;
-		std::shared_ptr<streamdeck::jsonrpc::request> req;
-	};
-	passed_data* pd = new passed_data();
-	pd->handle      = handle;
-	pd->req         = req;
-
 	// Some Frontend interaction requires a frontend task.
-	obs_queue_task(
-		obs_task_type::OBS_TASK_UI,
-		[](void* ptr) {
-			// Retrieve passed things and clean up immediately.
-			passed_data*                                  pd     = static_cast<passed_data*>(ptr);
-			std::weak_ptr<void>                           handle = pd->handle;
-			std::shared_ptr<streamdeck::jsonrpc::request> req    = pd->req;
-			delete pd;
-
-			std::shared_ptr<streamdeck::jsonrpc::response> res = std::make_shared<streamdeck::jsonrpc::response>();
-			res->copy_id(*req);
-			try {
-				nlohmann::json params;
-				req->get_params(params);
-				if (params.size() > 0) {
-					auto kv = params.find("profile");
-					if ((kv != params.end()) && (kv->is_string())) {
-						std::string collection;
-						kv->get_to(collection);
-						obs_frontend_set_current_profile(collection.c_str());
-					} else {
-						throw streamdeck::jsonrpc::invalid_params_error("'profile' must be a string value.");
-					}
-				}
-
-				char* profile = obs_frontend_get_current_profile();
-				res->set_result(profile ? profile : "");
-				bfree(profile);
-			} catch (streamdeck::jsonrpc::error const& ex) {
-				res->set_error(ex.id(), ex.what() ? ex.what() : "Unknown error.");
-			}
-			try {
-				res->validate();
-				streamdeck::server::instance()->reply(handle, res);
-			} catch (std::exception const& ex) {
-				DLOG(LOG_ERROR, "Failed to send reply: %s", ex.what());
+	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req, name = params.profile]() {
+		std::shared_ptr<streamdeck::jsonrpc::response> res = std::make_shared<streamdeck::jsonrpc::response>();
+		res->copy_id(*req);
+		try {
+			if (name) {
+				obs_frontend_set_current_profile(name->c_str());
 			}
-		},
-		pd, false);
+
+			char* profile = obs_frontend_get_current_profile();
+			res->set_result(profile ? profile : "");
+			bfree(profile);
+		} catch (streamdeck::jsonrpc::error const& ex) {
+			res->set_error(ex.id(), ex.what() ? ex.what() : "Unknown error.");
+		}
+		try {
+			res->validate();
+			streamdeck::server::instance()->reply(handle, res);
+		} catch (std::exception const& ex) {
+			DLOG(LOG_ERROR, "Failed to send reply: %s", ex.what());
+		}
+	});
 }
 
 void streamdeck::handlers::obs_frontend::profile_list(std::shared_ptr<streamdeck::jsonrpc::request>,
@@ -1172,10 +1032,11 @@ void streamdeck::handlers::obs_frontend::profile_list(std::shared_ptr<streamdeck
 	}
 	bfree(list);
 
-	res->set_result(profiles);
+	res->set_result(std::move(profiles));
 }
 
-void streamdeck::handlers::obs_frontend::scene(std::weak_ptr<void>                           handle,
+void streamdeck::handlers::obs_frontend::scene(const frontend_scene_params&                  params,
+											   std::weak_ptr<void>                           handle,
 											   std::shared_ptr<streamdeck::jsonrpc::request> req)
 {
 	/** obs.frontend.scene
@@ -1186,98 +1047,45 @@ void streamdeck::handlers::obs_frontend::scene(std::weak_ptr<void>
 	 * @return {string} The current scene in the selected output.
 	 */
 
-	// Validate parameters.
-	nlohmann::json params;
-	if (req->get_params(params)) {
-		{
-			auto p = params.find("program");
-			if (p != params.end()) {
-				if (!p->is_boolean()) {
-					throw jsonrpc::invalid_params_error("Parameter 'program' must be a Boolean.");
-				}
-			}
-		}
-
-		{
-			auto p = params.find("scene");
-			if (p != params.end()) {
-				if (!p->is_string()) {
-					throw jsonrpc::invalid_params_error("Parameter 'scene' must be a string or String.");
-				}
-			}
-		}
-	}
-
-	struct passed_data {
-		std::weak_ptr<void>                           handle;
-		std::shared_ptr<streamdeck::jsonrpc::request> req;
-	};
-	passed_data* pd = new passed_data();
-	pd->handle      = handle;
-	pd->req         = req;
+	bool is_program_scene = params.program.value_or(false);
 
 	// Some Frontend interaction requires a frontend task.
-	obs_queue_task(
-		obs_task_type::OBS_TASK_UI,
-		[](void* ptr) {
-			// Retrieve passed things and clean up immediately.
-			passed_data*                                  pd     = static_cast<passed_data*>(ptr);
-			std::weak_ptr<void>                           handle = pd->handle;
-			std::shared_ptr<streamdeck::jsonrpc::request> req    = pd->req;
-			delete pd;
-
-			std::shared_ptr<streamdeck::jsonrpc::response> res = std::make_shared<streamdeck::jsonrpc::response>();
-			res->copy_id(*req);
-			try {
-				nlohmann::json params;
-				req->get_params(params);
-
-				bool is_program_scene = false;
-				{
-					auto key = params.find("program");
-					if (key != params.end()) {
-						is_program_scene = key->get<bool>();
-					}
-				}
-
-				{
-					auto key = params.find("scene");
-					if (key != params.end()) {
-						std::string scene_name;
-						key->get_to(scene_name);
-
-						obs_source_t* scene = obs_get_source_by_name(scene_name.c_str());
-						if (!is_program_scene && obs_frontend_preview_program_mode_active()) {
-							obs_frontend_set_current_preview_scene(scene);
-						} else {
-							obs_frontend_set_current_scene(scene);
-						}
-						obs_source_release(scene);
-					}
-				}
-
-				obs_source_t* source = nullptr;
+	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false,
+						   [handle, req, is_program_scene, scene_name = params.scene]() {
+		std::shared_ptr<streamdeck::jsonrpc::response> res = std::make_shared<streamdeck::jsonrpc::response>();
+		res->copy_id(*req);
+		try {
+			if (scene_name) {
+				obs_source_t* scene = obs_get_source_by_name(scene_name->c_str());
 				if (!is_program_scene && obs_frontend_preview_program_mode_active()) {
-					source = obs_frontend_get_current_preview_scene();
+					obs_frontend_set_current_preview_scene(scene);
 				} else {
-					source = obs_frontend_get_current_scene();
+					obs_frontend_set_current_scene(scene);
 				}
-				const char* name = obs_source_get_name(source);
-				obs_source_release(source);
-
-				res->set_result(name ? name : "");
-			} catch (streamdeck::jsonrpc::error const& ex) {
-				res->set_error(ex.id(), ex.what() ? ex.what() : "Unknown error.");
+				obs_source_release(scene);
 			}
 
-			try {
-				res->validate();
-				streamdeck::server::instance()->reply(handle, res);
-			} catch (std::exception const& ex) {
-				DLOG(LOG_ERROR, "Failed to send reply: %s", ex.what());
+			obs_source_t* source = nullptr;
+			if (!is_program_scene && obs_frontend_preview_program_mode_active()) {
+				source = obs_frontend_get_current_preview_scene();
+			} else {
+				source = obs_frontend_get_current_scene();
 			}
-		},
-		pd, false);
+			const char* name = obs_source_get_name(source);
+			obs_source_release(source);
+
+			res->set_result(name ? name : "");
+		} catch (streamdeck::jsonrpc::error const& ex) {
+			res->set_error(ex.id(), ex.what() ? ex.what() : "Unknown error.");
+		}
+
+		try {
+			res->validate();
+			streamdeck::server::instance()->reply(handle, res);
+		} catch (std::exception const& ex) {
+			DLOG(LOG_ERROR, "Failed to send reply: %s", ex.what());
+		}
+	});
 }
 
 void streamdeck::handlers::obs_frontend::scene_list(std::shared_ptr<streamdeck::jsonrpc::request>,
@@ -1298,7 +1106,7 @@ void streamdeck::handlers::obs_frontend::scene_list(std::shared_ptr<streamdeck::
 	}
 	obs_frontend_source_list_free(&list);
 
-	res->set_result(scenes);
+	res->set_result(std::move(scenes));
 }
 
 void streamdeck::handlers::obs_frontend::transition(std::weak_ptr<void>                           handle,
@@ -1311,100 +1119,89 @@ void streamdeck::handlers::obs_frontend::transition(std::weak_ptr<void>
 	 * @return {{transition: string, duration: int}} The unique name of the current transition and the duration.
 	 */
 
-	struct task_data {
-		std::weak_ptr<void>                           handle;
-		std::shared_ptr<streamdeck::jsonrpc::request> req;
-	};
-	auto td    = new task_data;
-	td->req    = req;
-	td->handle = handle;
-
-	obs_queue_task(
-		obs_task_type::OBS_TASK_UI,
-		[](void* ptr) {
-			nlohmann::json params;
-			nlohmann::json p_transition;
-			nlohmann::json p_duration;
-			auto           td = reinterpret_cast<task_data*>(ptr);
-			try {
-				auto res = std::make_shared<streamdeck::jsonrpc::response>();
-				res->copy_id(*td->req);
-
-				if (td->req->get_params(params)) {
-					nlohmann::json::iterator param;
-
-					param = params.find("transition");
-					if (param != params.end()) {
-						if (param->is_string()) {
-							p_transition = *param;
-						} else {
-							throw jsonrpc::invalid_params_error(
-								"The parameter 'transition' must be of type 'string' if present.");
-						}
+	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req]() {
+		auto const&    params = req->get_params();
+		nlohmann::json p_transition;
+		nlohmann::json p_duration;
+		auto           td = reinterpret_cast<task_data*>(ptr);
+		try {
+			auto res = std::make_shared<streamdeck::jsonrpc::response>();
+			res->copy_id(*req);
+
+			if (!params.is_null()) {
+				nlohmann::json::const_iterator param;
+
+				param = params.find("transition");
+				if (param != params.end()) {
+					if (param->is_string()) {
+						p_transition = *param;
+					} else {
+						throw jsonrpc::invalid_params_error(
+							"The parameter 'transition' must be of type 'string' if present.");
 					}
+				}
 
-					param = params.find("duration");
-					if (param != params.end()) {
-						if (param->is_number_integer()) {
-							p_duration = *param;
-						} else {
-							throw jsonrpc::invalid_params_error(
-								"The parameter 'duration' must be of type 'integer' if present.");
-						}
+				param = params.find("duration");
+				if (param != params.end()) {
+					if (param->is_number_integer()) {
+						p_duration = *param;
+					} else {
+						throw jsonrpc::invalid_params_error(
+							"The parameter 'duration' must be of type 'integer' if present.");
 					}
 				}
+			}
 
-				if (p_transition.is_string()) {
-					auto fname = p_transition.get<std::string>();
-					auto list  = std::shared_ptr<obs_frontend_source_list>(
+			if (p_transition.is_string()) {
+				auto fname = p_transition.get<std::string>();
+				auto list  = std::shared_ptr<obs_frontend_source_list>(
                         new obs_frontend_source_list(),
                         [](obs_frontend_source_list* v) { obs_frontend_source_list_free(v); });
-					obs_frontend_get_transitions(list.get());
-
-					bool found = false;
-					for (size_t idx = 0; idx < list->sources.num; idx++) {
-						const char* name = obs_source_get_name(list->sources.array[idx]);
-						if (fname == name) {
-							obs_frontend_set_current_transition(list->sources.array[idx]);
-							found = true;
-							break;
-						}
-					}
+				obs_frontend_get_transitions(list.get());
 
-					if (!found) {
-						throw jsonrpc::invalid_params_error(
-							"The parameter 'transition' must describe an existing transition.");
+				bool found = false;
+				for (size_t idx = 0; idx < list->sources.num; idx++) {
+					const char* name = obs_source_get_name(list->sources.array[idx]);
+					if (fname == name) {
+						obs_frontend_set_current_transition(list->sources.array[idx]);
+						found = true;
+						break;
 					}
 				}
 
-				if (p_duration.is_number_integer()) {
-					obs_frontend_set_transition_duration(p_duration.get<int>());
+				if (!found) {
+					throw jsonrpc::invalid_params_error(
+						"The parameter 'transition' must describe an existing transition.");
 				}
+			}
 
-				{
-					auto source   = std::shared_ptr<obs_source_t>(obs_frontend_get_current_transition(),
+			if (p_duration.is_number_integer()) {
+				obs_frontend_set_transition_duration(p_duration.get<int>());
+			}
+
+			{
+				auto source   = std::shared_ptr<obs_source_t>(obs_frontend_get_current_transition(),
                                                                 [](obs_source_t* v) { obs_source_release(v); });
-					auto name     = obs_source_get_name(source.get());
-					auto duration = obs_frontend_get_transition_duration();
+				auto name     = obs_source_get_name(source.get());
+				auto duration = obs_frontend_get_transition_duration();
 
-					auto res_obj          = nlohmann::json::object();
-					res_obj["transition"] = name ? name : "";
-					res_obj["duration"]   = duration;
-					res->set_result(res_obj);
-				}
+				auto res_obj          = nlohmann::json::object();
+				res_obj["transition"] = name ? name : "";
+				res_obj["duration"]   = duration;
+				res->set_result(std::move(res_obj));
+			}
 
-				streamdeck::server::instance()->reply(td->handle, res);
-			} catch (const std::exception& ex) {
-				try {
-					auto res = std::make_shared<streamdeck::jsonrpc::response>();
-					res->copy_id(*td->req);
-					res->set_error(jsonrpc::SERVER_ERROR, ex.what());
-					streamdeck::server::instance()->reply(td->handle, res);
-				} catch (...) {
-				}
+			streamdeck::server::instance()->reply(handle, res);
+		} catch (const std::exception& ex) {
+			try {
+				auto res = std::make_shared<streamdeck::jsonrpc::response>();
+				res->copy_id(*req);
+				res->set_error(jsonrpc::SERVER_ERROR, ex.what());
+				streamdeck::server::instance()->reply(handle, res);
+			} catch (...) {
 			}
-		},
-		td, false);
+		}
+	});
 }
 
 void streamdeck::handlers::obs_frontend::transition_list(std::weak_ptr<void>                           handle,
@@ -1415,50 +1212,38 @@ void streamdeck::handlers::obs_frontend::transition_list(std::weak_ptr<void>
 	 * @return {Array({name: string, fixed: bool})} A list of unique names of transitions and whether their duration is fixed.
 	 */
 
-	struct task_data {
-		std::weak_ptr<void>                           handle;
-		std::shared_ptr<streamdeck::jsonrpc::request> req;
-	};
-	auto td    = new task_data;
-	td->req    = req;
-	td->handle = handle;
-
-	obs_queue_task(
-		obs_task_type::OBS_TASK_UI,
-		[](void* ptr) {
-			auto td = reinterpret_cast<task_data*>(ptr);
-			try {
-				auto list = std::shared_ptr<obs_frontend_source_list>(
-					new obs_frontend_source_list(),
-					[](obs_frontend_source_list* v) { obs_frontend_source_list_free(v); });
-				obs_frontend_get_transitions(list.get());
-
-				nlohmann::json data = nlohmann::json::array();
-				for (size_t idx = 0; idx < list->sources.num; idx++) {
-					const char* name  = obs_source_get_name(list->sources.array[idx]);
-					bool        fixed = obs_transition_fixed(list->sources.array[idx]);
-					auto        trans = nlohmann::json::object();
-					trans["name"]     = name ? name : "";
-					trans["fixed"]    = fixed;
-
-					data.push_back(trans);
-				}
+	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req]() {
+		try {
+			auto list = std::shared_ptr<obs_frontend_source_list>(
+				new obs_frontend_source_list(),
+				[](obs_frontend_source_list* v) { obs_frontend_source_list_free(v); });
+			obs_frontend_get_transitions(list.get());
+
+			nlohmann::json data = nlohmann::json::array();
+			for (size_t idx = 0; idx < list->sources.num; idx++) {
+				const char* name  = obs_source_get_name(list->sources.array[idx]);
+				bool        fixed = obs_transition_fixed(list->sources.array[idx]);
+				auto        trans = nlohmann::json::object();
+				trans["name"]     = name ? name : "";
+				trans["fixed"]    = fixed;
+
+				data.push_back(trans);
+			}
 
+			auto res = std::make_shared<streamdeck::jsonrpc::response>();
+			res->copy_id(*req);
+			res->set_result(std::move(data));
+			streamdeck::server::instance()->reply(handle, res);
+		} catch (const std::exception& ex) {
+			try {
 				auto res = std::make_shared<streamdeck::jsonrpc::response>();
-				res->copy_id(*td->req);
-				res->set_result(data);
-				streamdeck::server::instance()->reply(td->handle, res);
-			} catch (const std::exception& ex) {
-				try {
-					auto res = std::make_shared<streamdeck::jsonrpc::response>();
-					res->copy_id(*td->req);
-					res->set_error(jsonrpc::SERVER_ERROR, ex.what());
-					streamdeck::server::instance()->reply(td->handle, res);
-				} catch (...) {
-				}
+				res->copy_id(*req);
+				res->set_error(jsonrpc::SERVER_ERROR, ex.what());
+				streamdeck::server::instance()->reply(handle, res);
+			} catch (...) {
 			}
-		},
-		td, false);
+		}
+	});
 }
 
 void streamdeck::handlers::obs_frontend::screenshot(std::shared_ptr<streamdeck::jsonrpc::request>  req,
@@ -1469,11 +1254,11 @@ void streamdeck::handlers::obs_frontend::screenshot(std::shared_ptr<streamdeck::
 	 * @param source {string} [Optional] A source reference to take a screenshot of.
 	 */
 
-	nlohmann::json                params;
+	auto const&                   params = req->get_params();
 	std::shared_ptr<obs_source_t> source;
 
-	if (req->get_params(params)) { // Validate parameters.
-		nlohmann::json::iterator param;
+	if (!params.is_null()) { // Validate parameters.
+		nlohmann::json::const_iterator param;
 
 		param = params.find("source");
 		if (param != params.end()) {
@@ -1514,7 +1299,10 @@ void streamdeck::handlers::obs_frontend::stats(std::shared_ptr<streamdeck::jsonr
 
 	result["fpsTarget"] = obs_get_active_fps();
 	result["obsFps"] = (double)ovi.fps_num / (double)ovi.fps_den;
-	result["cpu"]       = os_cpu_usage_info_query(cpu_info);
+	{
+		std::unique_lock<std::mutex> lock(cpu_info_lock);
+		result["cpu"] = os_cpu_usage_info_query(cpu_info);
+	}
 	result["recording"] = nlohmann::json::object();
 	result["stream"]    = nlohmann::json::object();
 	#if OBS_MINIMUM_SUPPORT >= 280000
@@ -1578,7 +1366,7 @@ void streamdeck::handlers::obs_frontend::stats(std::shared_ptr<streamdeck::jsonr
 	// Bitrate				Calculate based on delta between stats calls using .type.bytes
 
 
-	res->set_result(result);
+	res->set_result(std::move(result));
 }
 
 
@@ -1594,7 +1382,7 @@ void streamdeck::handlers::obs_frontend::tbar(std::weak_ptr<void>
 	 */
 
 	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req]() {
-		nlohmann::json params;
+		auto const&    params = req->get_params();
 		nlohmann::json position;
 		nlohmann::json offset;
 		nlohmann::json release;
@@ -1607,11 +1395,11 @@ void streamdeck::handlers::obs_frontend::tbar(std::weak_ptr<void>
 			auto res_obj          = nlohmann::json::object();
 			res_obj       = tbar_pos;
 
-			if (!req->get_params(params)) {
-				res->set_result(res_obj);
+			if (params.is_null()) {
+				res->set_result(std::move(res_obj));
 				return;
 			}
-			nlohmann::json::iterator param;
+			nlohmann::json::const_iterator param;
 
 			param = params.find("position");
 			if (param != params.end()) {
@@ -1671,7 +1459,7 @@ void streamdeck::handlers::obs_frontend::tbar(std::weak_ptr<void>
 			}
 
 			res_obj = obs_frontend_get_tbar_position();
-			res->set_result(res_obj);
+			res->set_result(std::move(res_obj));
 			streamdeck::server::instance()->reply(handle, res);
 		} catch (const std::exception& ex) {
 			try {
@@ -1696,7 +1484,7 @@ void streamdeck::handlers::obs_frontend::recording_add_chapter(std::weak_ptr<voi
 	 */
 
 	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req]() {
-		nlohmann::json params;
+		auto const& params = req->get_params();
 		std::string name;
 		const char*    name_pointer = nullptr;
 
@@ -1705,8 +1493,8 @@ void streamdeck::handlers::obs_frontend::recording_add_chapter(std::weak_ptr<voi
 			res->copy_id(*req);
 
 
-			if (req->get_params(params)) {
-				nlohmann::json::iterator param;
+			if (!params.is_null()) {
+				nlohmann::json::const_iterator param;
 				param = params.find("name");
 				if (param != params.end()) {
 					if (param->is_string()) {
@@ -1724,7 +1512,7 @@ void streamdeck::handlers::obs_frontend::recording_add_chapter(std::weak_ptr<voi
 			}
 
 			auto result = obs_frontend_recording_add_chapter(name_pointer);
-			res->set_result(result);
+			res->set_result(std::move(result));
 			res->validate();
 			streamdeck::server::instance()->reply(handle, res);
 		} catch (const std::exception& ex) {
@@ -1750,7 +1538,7 @@ void streamdeck::handlers::obs_frontend::get_output(std::weak_ptr<void>
 
 
 	streamdeck::queue_task(obs_task_type::OBS_TASK_UI, false, [handle, req]() {
-		nlohmann::json params;
+		auto const&   params = req->get_params();
 		obs_output_t  *output = nullptr;
 
 		try {
@@ -1758,8 +1546,8 @@ void streamdeck::handlers::obs_frontend::get_output(std::weak_ptr<void>
 			res->copy_id(*req);
 			auto res_obj = nlohmann::json::object();
 
-			if (!req->get_params(params)) {
-				res->set_result(res_obj);
+			if (params.is_null()) {
+				res->set_result(std::move(res_obj));
 				return;
 			}
 			auto config = obs_frontend_get_profile_config();
@@ -1774,7 +1562,7 @@ void streamdeck::handlers::obs_frontend::get_output(std::weak_ptr<void>
 				res_obj["format"] = format;
 			}
 
-			res->set_result(res_obj);
+			res->set_result(std::move(res_obj));
 			res->validate();
 			streamdeck::server::instance()->reply(handle, res);
 
@@ -15,6 +15,8 @@
 
 #pragma once
 #include <memory>
+#include <mutex>
+#include "handler-params.hpp"
 #include "json-rpc.hpp"
 
 #include "obs-frontend-api.h"
@@ -70,7 +72,8 @@ namespace streamdeck {
 			void replaybuffer_active(std::shared_ptr<streamdeck::jsonrpc::request>,
 									 std::shared_ptr<streamdeck::jsonrpc::response>);
 
-			void studiomode(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>);
+			void studiomode(const frontend_studiomode_params&, std::weak_ptr<void>,
+							std::shared_ptr<streamdeck::jsonrpc::request>);
 			void studiomode_enable(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>);
 			void studiomode_disable(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>);
 			void studiomode_active(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>);
@@ -82,15 +85,18 @@ namespace streamdeck {
 
 			void transition_studio(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>);
 
-			void scenecollection(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>);
+			void scenecollection(const frontend_scenecollection_params&, std::weak_ptr<void>,
+								 std::shared_ptr<streamdeck::jsonrpc::request>);
 			void scenecollection_list(std::shared_ptr<streamdeck::jsonrpc::request>,
 									  std::shared_ptr<streamdeck::jsonrpc::response>);
 
-			void profile(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>);
+			void profile(const frontend_profile_params&, std::weak_ptr<void>,
+						 std::shared_ptr<streamdeck::jsonrpc::request>);
 			void profile_list(std::shared_ptr<streamdeck::jsonrpc::request>,
 									  std::shared_ptr<streamdeck::jsonrpc::response>);
 
-			void scene(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>);
+			void scene(const frontend_scene_params&, std::weak_ptr<void>,
+					   std::shared_ptr<streamdeck::jsonrpc::request>);
 			void scene_list(std::shared_ptr<streamdeck::jsonrpc::request>,
 							std::shared_ptr<streamdeck::jsonrpc::response>);
 
@@ -109,6 +115,7 @@ namespace streamdeck {
 
 			private:
 			os_cpu_usage_info_t* cpu_info;
+			std::mutex           cpu_info_lock; // Each query updates the previous sample kept in cpu_info.
 			std::string active_scene_collection;
 			std::string active_profile;
 			bool                 is_loaded;
@@ -44,14 +44,14 @@ static nlohmann::json build_sceneitem_transform(obs_sceneitem_t* item)
 		auto p = nlohmann::json::array();
 		p.push_back(ti.pos.x);
 		p.push_back(ti.pos.y);
-		o["position"] = p;
+		o["position"] = std::move(p);
 	}
 	o["rotation"] = ti.rot;
 	{
 		auto p = nlohmann::json::array();
 		p.push_back(ti.scale.x);
 		p.push_back(ti.scale.y);
-		o["scale"] = p;
+		o["scale"] = std::move(p);
 	}
 	o["alignment"] = ti.alignment;
 	{
@@ -63,10 +63,10 @@ static nlohmann::json build_sceneitem_transform(obs_sceneitem_t* item)
 			auto q = nlohmann::json::array();
 			q.push_back(ti.bounds.x);
 			q.push_back(ti.bounds.y);
-			p["size"] = q;
+			p["size"] = std::move(q);
 		}
 
-		o["bounds"] = p;
+		o["bounds"] = std::move(p);
 	}
 
 	return o;
@@ -106,7 +106,7 @@ static nlohmann::json build_sceneitem_reference(obs_scene_t * scene, obs_sceneit
 	return o;
 }
 
-static std::shared_ptr<obs_sceneitem_t> resolve_sceneitem_reference(nlohmann::json data)
+static std::shared_ptr<obs_sceneitem_t> resolve_sceneitem_reference(const nlohmann::json& data)
 {
 	// 1. Verify input parameters.
 	if (!data.is_array()) {
@@ -218,11 +218,22 @@ streamdeck::handlers::obs_scene::obs_scene()
 		signal_handler_connect(osh, "source_create", &on_source_create, this);
 	}
 
+	// Both only read through libobs, so they may run concurrently.
 	auto server = streamdeck::server::instance();
-	server->handle_sync("obs.scene.items", std::bind(&streamdeck::handlers::obs_scene::items, this,
-													 std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.scene.item.visible", std::bind(&streamdeck::handlers::obs_scene::item_visible, this,
-															std::placeholders::_1, std::placeholders::_2));
+	server->handle_query(scene_items_method,
+						 std::bind(&streamdeck::handlers::obs_scene::items, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3),
+						 {"scene"}, true);
+	server->handle_query(scene_item_visible_method,
+						 std::bind(&streamdeck::handlers::obs_scene::item_visible, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3),
+						 {"item"}, true);
+
+	// Queries whose outcome only changes along with one of these notifications.
+	server->set_watch_triggers("obs.scene.items", {"obs.scene.event.item.add", "obs.scene.event.item.remove",
+												   "obs.scene.event.item.visible", "obs.scene.event.item.transform",
+												   "obs.scene.event.reorder"});
+	server->set_watch_triggers("obs.scene.item.visible", {"obs.scene.event.item.visible"});
 }
 
 void streamdeck::handlers::obs_scene::on_source_create(void* ptr, calldata_t* calldata)
@@ -276,10 +287,12 @@ void streamdeck::handlers::obs_scene::on_item_add(void* ptr, calldata_t* calldat
 	}
 
 	// 2. Signal remote about changes.
-	nlohmann::json o = nlohmann::json::object();
-	o["item"]        = build_sceneitem_reference(scene, item);
-	o["state"]       = build_sceneitem_info(item);
-	streamdeck::server::instance()->notify("obs.scene.event.item.add", o);
+	streamdeck::server::instance()->notify("obs.scene.event.item.add", [&]() {
+		nlohmann::json o = nlohmann::json::object();
+		o["item"]        = build_sceneitem_reference(scene, item);
+		o["state"]       = build_sceneitem_info(item);
+		return o;
+	});
 
 }
 
@@ -294,43 +307,44 @@ void streamdeck::handlers::obs_scene::on_reorder(void*, calldata_t* calldata)
 		return;
 	}
 
-	// Enumerate the new structure of scene items.
-	nlohmann::json result = nlohmann::json::array();
-	obs_scene_enum_items(
-		scene,
-		[](obs_scene_t*, obs_sceneitem_t* item, void* ptr) {
-			nlohmann::json* result = static_cast<nlohmann::json*>(ptr);
-
-			if (obs_sceneitem_is_group(item)) {
-				nlohmann::json subresult = nlohmann::json::array();
-				subresult.push_back(obs_sceneitem_get_id(item));
-
-				obs_scene_enum_items(
-					obs_sceneitem_group_get_scene(item),
-					[](obs_scene_t*, obs_sceneitem_t* item, void* ptr) {
-						nlohmann::json* result = static_cast<nlohmann::json*>(ptr);
-						result->push_back(obs_sceneitem_get_id(item));
-
-						return true;
-					},
-					&subresult);
-
-				result->push_back(subresult);
-
-			} else {
-				DLOG(LOG_WARNING, "Got item %d", obs_sceneitem_get_id(item));
-				result->push_back(obs_sceneitem_get_id(item));
-			}
-
-			return true;
-		},
-		&result);
-
-	// Signal remote about changes.
-	nlohmann::json o = nlohmann::json::object();
-	o["scene"]       = obs_source_get_name(obs_scene_get_source(scene));
-	o["items"]       = result;
-	streamdeck::server::instance()->notify("obs.scene.event.reorder", o);
+	// Signal remote about changes, enumerating the new structure of scene items only if anyone listens.
+	streamdeck::server::instance()->notify("obs.scene.event.reorder", [&]() {
+		nlohmann::json result = nlohmann::json::array();
+		obs_scene_enum_items(
+			scene,
+			[](obs_scene_t*, obs_sceneitem_t* item, void* ptr) {
+				nlohmann::json* result = static_cast<nlohmann::json*>(ptr);
+
+				if (obs_sceneitem_is_group(item)) {
+					nlohmann::json subresult = nlohmann::json::array();
+					subresult.push_back(obs_sceneitem_get_id(item));
+
+					obs_scene_enum_items(
+						obs_sceneitem_group_get_scene(item),
+						[](obs_scene_t*, obs_sceneitem_t* item, void* ptr) {
+							nlohmann::json* result = static_cast<nlohmann::json*>(ptr);
+							result->push_back(obs_sceneitem_get_id(item));
+
+							return true;
+						},
+						&subresult);
+
+					result->push_back(std::move(subresult));
+
+				} else {
+					DLOG(LOG_WARNING, "Got item %d", obs_sceneitem_get_id(item));
+					result->push_back(obs_sceneitem_get_id(item));
+				}
+
+				return true;
+			},
+			&result);
+
+		nlohmann::json o = nlohmann::json::object();
+		o["scene"]       = obs_source_get_name(obs_scene_get_source(scene));
+		o["items"]       = std::move(result);
+		return o;
+	});
 }
 
 void streamdeck::handlers::obs_scene::on_item_remove(void* ptr, calldata_t* calldata)
@@ -350,10 +364,12 @@ void streamdeck::handlers::obs_scene::on_item_remove(void* ptr, calldata_t* call
 	}
 
 	// 2. Signal remote about changes.
-	nlohmann::json o = nlohmann::json::object();
-	o["item"]        = build_sceneitem_reference(scene, item);
-	o["state"]       = build_sceneitem_info(item);
-	streamdeck::server::instance()->notify("obs.scene.event.item.remove", o);
+	streamdeck::server::instance()->notify("obs.scene.event.item.remove", [&]() {
+		nlohmann::json o = nlohmann::json::object();
+		o["item"]        = build_sceneitem_reference(scene, item);
+		o["state"]       = build_sceneitem_info(item);
+		return o;
+	});
 }
 
 void streamdeck::handlers::obs_scene::on_item_visible(void*, calldata_t* calldata)
@@ -379,10 +395,12 @@ void streamdeck::handlers::obs_scene::on_item_visible(void*, calldata_t* calldat
 	}
 
 	// 2. Signal remote about changes.
-	nlohmann::json o = nlohmann::json::object();
-	o["item"]        = build_sceneitem_reference(scene, item);
-	o["state"]       = build_sceneitem_info(item);
-	streamdeck::server::instance()->notify("obs.scene.event.item.visible", o);
+	streamdeck::server::instance()->notify("obs.scene.event.item.visible", [&]() {
+		nlohmann::json o = nlohmann::json::object();
+		o["item"]        = build_sceneitem_reference(scene, item);
+		o["state"]       = build_sceneitem_info(item);
+		return o;
+	});
 }
 
 void streamdeck::handlers::obs_scene::on_item_transform(void* ptr, calldata_t* calldata)
@@ -404,13 +422,18 @@ void streamdeck::handlers::obs_scene::on_item_transform(void* ptr, calldata_t* c
 	}
 
 	// 2. Signal remote about changes.
-	nlohmann::json o = nlohmann::json::object();
-	o["item"]        = build_sceneitem_reference(scene, item);
-	o["state"]       = build_sceneitem_info(item);
-	streamdeck::server::instance()->notify("obs.scene.event.item.transform", o);
+	// Dragging in the preview emits this for every frame, only the latest transform per item matters.
+	auto key = std::to_string(reinterpret_cast<uintptr_t>(item));
+	streamdeck::server::instance()->notify_coalesced("obs.scene.event.item.transform", key, [&]() {
+		nlohmann::json o = nlohmann::json::object();
+		o["item"]        = build_sceneitem_reference(scene, item);
+		o["state"]       = build_sceneitem_info(item);
+		return o;
+	});
 }
 
-void streamdeck::handlers::obs_scene::items(std::shared_ptr<streamdeck::jsonrpc::request>  req,
+void streamdeck::handlers::obs_scene::items(const scene_items_params&                      params,
+											std::shared_ptr<streamdeck::jsonrpc::request>,
 											std::shared_ptr<streamdeck::jsonrpc::response> res)
 {
 	/** obs.scene.items
@@ -420,29 +443,14 @@ void streamdeck::handlers::obs_scene::items(std::shared_ptr<streamdeck::jsonrpc:
 	 * @return {Array(string)} An array of strings of all available items in the scene.
 	 */
 
-	// 1. Validate parameters.
-	nlohmann::json parameters;
-	if (!req->get_params(parameters)) {
-		throw jsonrpc::invalid_params_error("Missing parameters.");
-	}
-
-	// 2. Figure out which scene we want to look for.
-	auto p_scene = parameters.find("scene");
-	if (p_scene == parameters.end()) {
-		throw jsonrpc::invalid_params_error("'scene' must be present.");
-	} else if (!p_scene->is_string()) {
-		throw jsonrpc::invalid_params_error("'scene' must be of type 'string'.");
-	}
-
-	// 3. Resolve the scene to a source.
-	std::string                   scene_ = p_scene->get<std::string>();
+	// 1. Resolve the scene to a source.
 	std::shared_ptr<obs_source_t> source =
-		std::shared_ptr<obs_source_t>(obs_get_source_by_name(scene_.c_str()), obs_source_deleter);
+		std::shared_ptr<obs_source_t>(obs_get_source_by_name(params.scene->c_str()), obs_source_deleter);
 	if (!source) {
 		throw jsonrpc::invalid_params_error("'scene' does not describe an existing source or scene.");
 	}
 
-	// 4. Get the actual scene or group.
+	// 2. Get the actual scene or group.
 	obs_scene_t* scene = obs_scene_from_source(source.get());
 	if (!scene) {
 		scene = obs_group_from_source(source.get());
@@ -451,7 +459,7 @@ void streamdeck::handlers::obs_scene::items(std::shared_ptr<streamdeck::jsonrpc:
 		}
 	}
 
-	// 5. Finally enumerate the items in said scene.
+	// 3. Finally enumerate the items in said scene.
 	nlohmann::json result = nlohmann::json::array();
 	obs_scene_enum_items(
 		scene,
@@ -461,10 +469,11 @@ void streamdeck::handlers::obs_scene::items(std::shared_ptr<streamdeck::jsonrpc:
 			return true;
 		},
 		&result);
-	res->set_result(result);
+	res->set_result(std::move(result));
 }
 
-void streamdeck::handlers::obs_scene::item_visible(std::shared_ptr<streamdeck::jsonrpc::request>  req,
+void streamdeck::handlers::obs_scene::item_visible(const scene_item_visible_params&               params,
+												   std::shared_ptr<streamdeck::jsonrpc::request>,
 												   std::shared_ptr<streamdeck::jsonrpc::response> res)
 {
 	/** obs.scene.item.visible
@@ -475,27 +484,12 @@ void streamdeck::handlers::obs_scene::item_visible(std::shared_ptr<streamdeck::j
 	 * @return {bool} `true` if visible, otherwise `false`.
 	 */
 
-	// 1. Validate parameters.
-	nlohmann::json parameters;
-	if (!req->get_params(parameters)) {
-		throw jsonrpc::invalid_params_error("Missing parameters.");
-	}
+	// 1. Resolve the scene item.
+	auto item = resolve_sceneitem_reference(*params.item);
 
-	// 2. Resolve the scene item.
-	auto p_item = parameters.find("item");
-	if (p_item == parameters.end()) {
-		throw jsonrpc::invalid_params_error("'item' must be present.");
-	}
-	auto item = resolve_sceneitem_reference(p_item->get<nlohmann::json>());
-
-	// 3. Update state according to parameters.
-	auto p_visible = parameters.find("visible");
-	if (p_visible != parameters.end()) {
-		if (p_visible->is_boolean()) {
-			obs_sceneitem_set_visible(item.get(), p_visible->get<bool>());
-		} else {
-			throw jsonrpc::invalid_params_error("'visible' must be of type 'boolean' if present.");
-		}
+	// 2. Update state according to parameters.
+	if (params.visible) {
+		obs_sceneitem_set_visible(item.get(), *params.visible);
 	}
 
 	res->set_result(obs_sceneitem_visible(item.get()));
@@ -15,6 +15,7 @@
 
 #pragma once
 #include <memory>
+#include "handler-params.hpp"
 #include "json-rpc.hpp"
 
 #include <callback/signal.h>
@@ -40,9 +41,10 @@ namespace streamdeck {
 			static void on_item_transform(void* ptr, calldata_t* calldata);
 
 			private /* Scenes */:
-			void items(std::shared_ptr<streamdeck::jsonrpc::request>, std::shared_ptr<streamdeck::jsonrpc::response>);
+			void items(const scene_items_params&, std::shared_ptr<streamdeck::jsonrpc::request>,
+					   std::shared_ptr<streamdeck::jsonrpc::response>);
 
-			void item_visible(std::shared_ptr<streamdeck::jsonrpc::request>,
+			void item_visible(const scene_item_visible_params&, std::shared_ptr<streamdeck::jsonrpc::request>,
 							  std::shared_ptr<streamdeck::jsonrpc::response>);
 
 		};
@@ -18,6 +18,7 @@
 #include <thread>
 #include "module.hpp"
 #include "server.hpp"
+#include "source-metadata.hpp"
 #include <util/platform.h>
 
 #include <callback/signal.h>
@@ -39,7 +40,7 @@ static std::map<obs_source_type, std::string> type_map = {
 	{OBS_SOURCE_TYPE_TRANSITION, "transition"},
 	{OBS_SOURCE_TYPE_SCENE, "scene"},
 };
-static std::map<uint32_t, std::string> output_flag_map = {
+static streamdeck::handlers::flag_names_t output_flag_map = {
 	{OBS_SOURCE_VIDEO, "video"},
 	{OBS_SOURCE_AUDIO, "audio"},
 	{OBS_SOURCE_ASYNC, "async"},
@@ -54,7 +55,7 @@ static std::map<uint32_t, std::string> output_flag_map = {
 	{OBS_SOURCE_SUBMIX, "submix"},
 	{OBS_SOURCE_CONTROLLABLE_MEDIA, "controllable_media"},
 };
-static std::map<uint32_t, std::string> flag_map = {
+static streamdeck::handlers::flag_names_t flag_map = {
 	{OBS_SOURCE_FLAG_UNUSED_1, "unused_1"},
 	{OBS_SOURCE_FLAG_FORCE_MONO, "force_mono"},
 };
@@ -136,7 +137,7 @@ static std::map<obs_icon_type, std::string> icon_type_map = {
 	{OBS_ICON_TYPE_CUSTOM, "custom"},
 };
 
-static std::shared_ptr<obs_source> resolve_source_reference(nlohmann::json value)
+static std::shared_ptr<obs_source> resolve_source_reference(const nlohmann::json& value)
 {
 	if (value.is_array()) {
 		if (value.size() == 0) {
@@ -179,101 +180,54 @@ static nlohmann::json build_source_reference(obs_source_t* source)
 	}
 }
 
-static nlohmann::json build_source_media_metadata(obs_source_t* source)
+template<typename K>
+static const char* find_name(const std::map<K, std::string>& map, K key)
 {
-	nlohmann::json res = nlohmann::json::object();
-
-	{
-		auto kv = media_state_map.find(obs_source_media_get_state(source));
-		if (kv != media_state_map.end()) {
-			res["status"] = kv->second;
-		} else {
-			res["status"] = nlohmann::json();
-		}
-	}
-
-	{
-		auto o = nlohmann::json::array();
-		o.push_back(obs_source_media_get_time(source));
-		o.push_back(obs_source_media_get_duration(source));
-		res["time"] = o;
-	}
+	auto kv = map.find(key);
+	return (kv != map.end()) ? kv->second.c_str() : nullptr;
+}
 
+static streamdeck::handlers::source_media_metadata read_source_media_metadata(obs_source_t* source)
+{
+	streamdeck::handlers::source_media_metadata res;
+	res.status   = find_name(media_state_map, obs_source_media_get_state(source));
+	res.time     = obs_source_media_get_time(source);
+	res.duration = obs_source_media_get_duration(source);
 	return res;
 }
 
-static nlohmann::json build_source_metadata(obs_source_t* source)
+static nlohmann::json build_source_media_metadata(obs_source_t* source)
 {
-	nlohmann::json res  = nlohmann::json::object();
-	const char*    name = obs_source_get_name(source);
-
-	// The current name of the source.
-	res["id"]             = obs_source_get_id(source);
-	res["id_unversioned"] = obs_source_get_unversioned_id(source);
-	res["name"]           = name ? name : "";
-
-	{
-		auto kv = type_map.find(obs_source_get_type(source));
-		if (kv != type_map.end()) {
-			res["type"] = kv->second;
-		} else {
-			res["type"] = nlohmann::json();
-		}
-	}
-
-	res["enabled"] = obs_source_enabled(source);
-	res["active"]  = obs_source_active(source);
-	res["visible"] = obs_source_showing(source);
-
-	{ // Output Flags
-		auto o  = nlohmann::json::object();
-		auto of = obs_source_get_output_flags(source);
-		for (auto kv : output_flag_map) {
-			o[kv.second] = (of & kv.first) ? true : false;
-		}
-		res["output_flags"] = o;
-		res["outputflags"]  = o; // Deprecated
-	}
-
-	{ // Size and Base Size
-		auto o = nlohmann::json::array();
-		o.push_back(obs_source_get_width(source));
-		o.push_back(obs_source_get_height(source));
-		o.push_back(obs_source_get_base_width(source));
-		o.push_back(obs_source_get_base_height(source));
-		res["size"] = o;
-	}
-
-	{ // Flags
-		auto o  = nlohmann::json::object();
-		auto of = obs_source_get_flags(source);
-		for (auto kv : flag_map) {
-			o[kv.second] = (of & kv.first) ? true : false;
-		}
-		res["flags"] = o;
-	}
-
-	{ // Audio
-		auto o = nlohmann::json::object();
-		{
-			auto kv = speaker_layout_map.find(obs_source_get_speaker_layout(source));
-			if (kv != speaker_layout_map.end()) {
-				o["layout"] = kv->second;
-			} else {
-				o["layout"] = nlohmann::json();
-			}
-		}
-		o["muted"]       = obs_source_muted(source);
-		o["volume"]      = obs_source_get_volume(source);
-		o["balance"]     = obs_source_get_balance_value(source);
-		o["sync_offset"] = obs_source_get_sync_offset(source);
-		o["mixers"]      = obs_source_get_audio_mixers(source);
-		res["audio"]     = o;
-	}
-
-	res["media"] = build_source_media_metadata(source);
+	return read_source_media_metadata(source).to_json();
+}
 
-	return res;
+static nlohmann::json build_source_metadata(obs_source_t* source)
+{
+	streamdeck::handlers::source_metadata res;
+	res.id             = obs_source_get_id(source);
+	res.id_unversioned = obs_source_get_unversioned_id(source);
+	res.name           = obs_source_get_name(source);
+	res.type           = find_name(type_map, obs_source_get_type(source));
+	res.enabled        = obs_source_enabled(source);
+	res.active         = obs_source_active(source);
+	res.visible        = obs_source_showing(source);
+	res.output_flags   = obs_source_get_output_flags(source);
+	res.flags          = obs_source_get_flags(source);
+	res.width          = obs_source_get_width(source);
+	res.height         = obs_source_get_height(source);
+	res.base_width     = obs_source_get_base_width(source);
+	res.base_height    = obs_source_get_base_height(source);
+
+	res.audio.layout      = find_name(speaker_layout_map, obs_source_get_speaker_layout(source));
+	res.audio.muted       = obs_source_muted(source);
+	res.audio.volume      = obs_source_get_volume(source);
+	res.audio.balance     = obs_source_get_balance_value(source);
+	res.audio.sync_offset = obs_source_get_sync_offset(source);
+	res.audio.mixers      = obs_source_get_audio_mixers(source);
+
+	res.media = read_source_media_metadata(source);
+
+	return res.to_json(output_flag_map, flag_map);
 }
 
 nlohmann::json build_properties_metadata(obs_properties_t* props)
@@ -311,7 +265,7 @@ nlohmann::json build_properties_metadata(obs_properties_t* props)
 				o["max"]  = obs_property_int_max(prop);
 				o["step"] = obs_property_int_step(prop);
 
-				res2["limits"] = o;
+				res2["limits"] = std::move(o);
 			}
 			res2["suffix"] = obs_property_int_suffix(prop);
 			break;
@@ -329,7 +283,7 @@ nlohmann::json build_properties_metadata(obs_properties_t* props)
 				o["max"]  = obs_property_float_max(prop);
 				o["step"] = obs_property_float_step(prop);
 
-				res2["limits"] = o;
+				res2["limits"] = std::move(o);
 			}
 			res2["suffix"] = obs_property_float_suffix(prop);
 			break;
@@ -379,7 +333,7 @@ nlohmann::json build_properties_metadata(obs_properties_t* props)
 						break;
 					}
 				}
-				res2["items"] = o;
+				res2["items"] = std::move(o);
 			}
 
 			break;
@@ -411,9 +365,9 @@ nlohmann::json build_properties_metadata(obs_properties_t* props)
 					p["name"]    = obs_property_list_item_name(prop, idx);
 					p["enabled"] = !obs_property_list_item_disabled(prop, idx);
 					p["value"]   = obs_property_list_item_string(prop, idx);
-					o.push_back(p);
+					o.push_back(std::move(p));
 				}
-				res2["items"] = o;
+				res2["items"] = std::move(o);
 			}
 			break;
 		}
@@ -424,9 +378,9 @@ nlohmann::json build_properties_metadata(obs_properties_t* props)
 					auto p     = nlohmann::json::object();
 					p["name"]  = obs_property_frame_rate_option_description(prop, idx);
 					p["value"] = obs_property_frame_rate_option_name(prop, idx);
-					o.push_back(p);
+					o.push_back(std::move(p));
 				}
-				res2["options"] = o;
+				res2["options"] = std::move(o);
 			}
 			{
 				auto o = nlohmann::json::object();
@@ -439,17 +393,17 @@ nlohmann::json build_properties_metadata(obs_properties_t* props)
 						auto m = nlohmann::json::array();
 						m.push_back(min_fps.numerator);
 						m.push_back(min_fps.denominator);
-						p["min"] = m;
+						p["min"] = std::move(m);
 					}
 					{
 						auto m = nlohmann::json::array();
 						m.push_back(max_fps.numerator);
 						m.push_back(max_fps.denominator);
-						p["max"] = m;
+						p["max"] = std::move(m);
 					}
-					o.push_back(p);
+					o.push_back(std::move(p));
 				}
-				res2["ranges"] = o;
+				res2["ranges"] = std::move(o);
 			}
 			break;
 		}
@@ -467,7 +421,7 @@ nlohmann::json build_properties_metadata(obs_properties_t* props)
 		default:
 			break;
 		}
-		res.push_back(res2);
+		res.push_back(std::move(res2));
 	}
 	return res;
 }
@@ -603,21 +557,49 @@ streamdeck::handlers::obs_source::obs_source()
 		signal_handler_connect(osh, "source_create", &on_source_create, this);
 	}
 
+	// These only read through libobs, like the notifications built on whichever thread emitted a signal, so they
+	// may run concurrently. Properties come from the source's own callback, which may expect a single thread.
 	auto server = streamdeck::server::instance();
-	server->handle_sync("obs.source.enumerate", std::bind(&streamdeck::handlers::obs_source::enumerate, this,
-														  std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.source.state", std::bind(&streamdeck::handlers::obs_source::state, this,
-													  std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.source.filters", std::bind(&streamdeck::handlers::obs_source::filters, this,
-														std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.source.settings", std::bind(&streamdeck::handlers::obs_source::settings, this,
-														 std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.source.media", std::bind(&streamdeck::handlers::obs_source::media, this,
-													  std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.source.properties", std::bind(&streamdeck::handlers::obs_source::properties, this,
-														   std::placeholders::_1, std::placeholders::_2));
-	server->handle_sync("obs.source.icons", std::bind(&streamdeck::handlers::obs_source::icons, this,
-														   std::placeholders::_1, std::placeholders::_2));
+	server->handle_query("obs.source.enumerate",
+						 std::bind(&streamdeck::handlers::obs_source::enumerate, this, std::placeholders::_1,
+								   std::placeholders::_2),
+						 {}, true);
+	server->handle_query(source_state_method,
+						 std::bind(&streamdeck::handlers::obs_source::state, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3),
+						 {"source"}, true);
+	server->handle_query(source_filters_method,
+						 std::bind(&streamdeck::handlers::obs_source::filters, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3),
+						 {"source"}, true);
+	server->handle_query(source_settings_method,
+						 std::bind(&streamdeck::handlers::obs_source::settings, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3),
+						 {"source"}, true);
+	server->handle_query(source_media_method,
+						 std::bind(&streamdeck::handlers::obs_source::media, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3),
+						 {"source"}, true);
+	server->handle_query(source_properties_method,
+						 std::bind(&streamdeck::handlers::obs_source::properties, this, std::placeholders::_1,
+								   std::placeholders::_2, std::placeholders::_3),
+						 {"source"});
+	server->handle_query("obs.source.icons",
+						 std::bind(&streamdeck::handlers::obs_source::icons, this, std::placeholders::_1,
+								   std::placeholders::_2),
+						 {}, true);
+
+	// Queries whose outcome only changes along with one of these notifications.
+	server->set_watch_triggers("obs.source.enumerate",
+							   {"obs.source.event.create", "obs.source.event.destroy", "obs.source.event.rename"});
+	server->set_watch_triggers("obs.source.state", {"obs.source.event.state", "obs.source.event.create",
+													"obs.source.event.destroy", "obs.source.event.rename"});
+	server->set_watch_triggers("obs.source.filters",
+							   {"obs.source.event.filter.add", "obs.source.event.filter.remove",
+								"obs.source.event.filter.reorder", "obs.source.event.create",
+								"obs.source.event.destroy", "obs.source.event.rename"});
+	server->set_watch_triggers("obs.source.media", {"obs.source.event.media", "obs.source.event.create",
+													"obs.source.event.destroy", "obs.source.event.rename"});
 }
 
 void streamdeck::handlers::obs_source::on_source_create(void* ptr, calldata_t* calldata)
@@ -632,8 +614,7 @@ void streamdeck::handlers::obs_source::on_source_create(void* ptr, calldata_t* c
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = build_source_metadata(source);
-	streamdeck::server::instance()->notify("obs.source.event.create", reply);
+	streamdeck::server::instance()->notify("obs.source.event.create", [&]() { return build_source_metadata(source); });
 
 	// Add listeners for other signals.
 	listen_source_signals(source, ptr);
@@ -651,10 +632,11 @@ void streamdeck::handlers::obs_source::on_destroy(void* ptr, calldata_t* calldat
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(source);
-
-	streamdeck::server::instance()->notify("obs.source.event.destroy", reply);
+	streamdeck::server::instance()->notify("obs.source.event.destroy", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(source);
+		return reply;
+	});
 
 	// Remove listeners for other signals.
 	silence_source_signals(source, ptr);
@@ -686,12 +668,13 @@ void streamdeck::handlers::obs_source::on_rename(void*, calldata_t* calldata)
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(source);
-	reply["from"]        = old_name ? old_name : "";
-	reply["to"]          = new_name ? new_name : "";
-
-	streamdeck::server::instance()->notify("obs.source.event.rename", reply);
+	streamdeck::server::instance()->notify("obs.source.event.rename", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(source);
+		reply["from"]        = old_name ? old_name : "";
+		reply["to"]          = new_name ? new_name : "";
+		return reply;
+	});
 }
 
 void streamdeck::handlers::obs_source::on_enable(void*, calldata_t* calldata)
@@ -706,10 +689,12 @@ void streamdeck::handlers::obs_source::on_enable(void*, calldata_t* calldata)
 	}
 
 	{ // obs.source.event.state
-		nlohmann::json reply = nlohmann::json::object();
-		reply["source"]      = build_source_reference(source);
-		reply["state"]       = build_source_metadata(source);
-		streamdeck::server::instance()->notify("obs.source.event.state", reply);
+		streamdeck::server::instance()->notify("obs.source.event.state", [&]() {
+			nlohmann::json reply = nlohmann::json::object();
+			reply["source"]      = build_source_reference(source);
+			reply["state"]       = build_source_metadata(source);
+			return reply;
+		});
 	}
 }
 
@@ -727,11 +712,13 @@ void streamdeck::handlers::obs_source::on_activate(void*, calldata_t* calldata)
 	}
 
 	{ // obs.source.event.state
-		nlohmann::json reply = nlohmann::json::object();
-		reply["source"]      = build_source_reference(source);
-		reply["state"]       = build_source_metadata(source);
-		reply["state"]["active"] = true;
-		streamdeck::server::instance()->notify("obs.source.event.state", reply);
+		streamdeck::server::instance()->notify("obs.source.event.state", [&]() {
+			nlohmann::json reply = nlohmann::json::object();
+			reply["source"]      = build_source_reference(source);
+			reply["state"]       = build_source_metadata(source);
+			reply["state"]["active"] = true;
+			return reply;
+		});
 	}
 }
 
@@ -749,11 +736,13 @@ void streamdeck::handlers::obs_source::on_deactivate(void*, calldata_t* calldata
 	}
 
 	{ // obs.source.event.state
-		nlohmann::json reply = nlohmann::json::object();
-		reply["source"]      = build_source_reference(source);
-		reply["state"]       = build_source_metadata(source);
-		reply["state"]["active"] = false;
-		streamdeck::server::instance()->notify("obs.source.event.state", reply);
+		streamdeck::server::instance()->notify("obs.source.event.state", [&]() {
+			nlohmann::json reply = nlohmann::json::object();
+			reply["source"]      = build_source_reference(source);
+			reply["state"]       = build_source_metadata(source);
+			reply["state"]["active"] = false;
+			return reply;
+		});
 	}
 }
 
@@ -769,11 +758,13 @@ void streamdeck::handlers::obs_source::on_show(void*, calldata_t* calldata)
 	}
 
 	{ // obs.source.event.state
-		nlohmann::json reply = nlohmann::json::object();
-		reply["source"]      = build_source_reference(source);
-		reply["state"]       = build_source_metadata(source);
-		reply["state"]["visible"] = true;
-		streamdeck::server::instance()->notify("obs.source.event.state", reply);
+		streamdeck::server::instance()->notify("obs.source.event.state", [&]() {
+			nlohmann::json reply = nlohmann::json::object();
+			reply["source"]      = build_source_reference(source);
+			reply["state"]       = build_source_metadata(source);
+			reply["state"]["visible"] = true;
+			return reply;
+		});
 	}
 }
 
@@ -789,11 +780,13 @@ void streamdeck::handlers::obs_source::on_hide(void*, calldata_t* calldata)
 	}
 
 	{ // obs.source.event.state
-		nlohmann::json reply = nlohmann::json::object();
-		reply["source"]           = build_source_reference(source);
-		reply["state"]            = build_source_metadata(source);
-		reply["state"]["visible"] = false;
-		streamdeck::server::instance()->notify("obs.source.event.state", reply);
+		streamdeck::server::instance()->notify("obs.source.event.state", [&]() {
+			nlohmann::json reply = nlohmann::json::object();
+			reply["source"]           = build_source_reference(source);
+			reply["state"]            = build_source_metadata(source);
+			reply["state"]["visible"] = false;
+			return reply;
+		});
 	}
 }
 
@@ -815,11 +808,13 @@ void streamdeck::handlers::obs_source::on_mute(void*, calldata_t* calldata)
 	}
 
 	{ // obs.source.event.state
-		nlohmann::json reply = nlohmann::json::object();
-		reply["source"]      = build_source_reference(source);
-		reply["state"]       = build_source_metadata(source);
-		reply["state"]["audio"]["muted"] = muted;
-		streamdeck::server::instance()->notify("obs.source.event.state", reply);
+		streamdeck::server::instance()->notify("obs.source.event.state", [&]() {
+			nlohmann::json reply = nlohmann::json::object();
+			reply["source"]      = build_source_reference(source);
+			reply["state"]       = build_source_metadata(source);
+			reply["state"]["audio"]["muted"] = muted;
+			return reply;
+		});
 	}
 }
 
@@ -841,11 +836,16 @@ void streamdeck::handlers::obs_source::on_volume(void*, calldata_t* calldata)
 	}
 
 	{ // obs.source.event.state
-		nlohmann::json reply = nlohmann::json::object();
-		reply["source"]      = build_source_reference(source);
-		reply["state"]       = build_source_metadata(source);
-		reply["state"]["audio"]["volume"] = volume;
-		streamdeck::server::instance()->notify("obs.source.event.state", reply);
+		// Faders emit this for every step, only the latest value per source matters. The address identifies the
+		// source without building its reference first.
+		auto key = std::to_string(reinterpret_cast<uintptr_t>(source));
+		streamdeck::server::instance()->notify_coalesced("obs.source.event.state", key, [&]() {
+			nlohmann::json reply              = nlohmann::json::object();
+			reply["source"]                   = build_source_reference(source);
+			reply["state"]                    = build_source_metadata(source);
+			reply["state"]["audio"]["volume"] = volume;
+			return reply;
+		});
 	}
 }
 
@@ -867,10 +867,12 @@ void streamdeck::handlers::obs_source::on_filter_add(void* ptr, calldata_t* call
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(source);
-	reply["filter"]      = build_source_metadata(filter);
-	streamdeck::server::instance()->notify("obs.source.event.filter.add", reply);
+	streamdeck::server::instance()->notify("obs.source.event.filter.add", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(source);
+		reply["filter"]      = build_source_metadata(filter);
+		return reply;
+	});
 
 	// Filters are private sources, we need to listen to them as well.
 	listen_source_signals(filter, ptr);
@@ -894,9 +896,11 @@ void streamdeck::handlers::obs_source::on_filter_remove(void* ptr, calldata_t* c
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(filter);
-	streamdeck::server::instance()->notify("obs.source.event.filter.remove", reply);
+	streamdeck::server::instance()->notify("obs.source.event.filter.remove", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(filter);
+		return reply;
+	});
 
 	// Filters are private sources, we need to silence the listened signals.
 	silence_source_signals(filter, ptr);
@@ -920,20 +924,22 @@ void streamdeck::handlers::obs_source::on_filter_reorder(void* ptr, calldata_t*
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(filter);
-	{
-		nlohmann::json result = nlohmann::json::array();
-		obs_source_enum_filters(
-			source,
-			[](obs_source_t*, obs_source_t* filter, void* ptr) {
-				nlohmann::json* result = static_cast<nlohmann::json*>(ptr);
-				result->push_back(build_source_metadata(filter));
-			},
-			&result);
-		reply["order"] = result;
-	}
-	streamdeck::server::instance()->notify("obs.source.event.filter.reorder", reply);
+	streamdeck::server::instance()->notify("obs.source.event.filter.reorder", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(filter);
+		{
+			nlohmann::json result = nlohmann::json::array();
+			obs_source_enum_filters(
+				source,
+				[](obs_source_t*, obs_source_t* filter, void* ptr) {
+					nlohmann::json* result = static_cast<nlohmann::json*>(ptr);
+					result->push_back(build_source_metadata(filter));
+				},
+				&result);
+			reply["order"] = std::move(result);
+		}
+		return reply;
+	});
 }
 
 void streamdeck::handlers::obs_source::on_media_play(void*, calldata_t* calldata)
@@ -952,12 +958,13 @@ void streamdeck::handlers::obs_source::on_media_play(void*, calldata_t* calldata
 		os_sleep_ms(100);
 		queue_task(obs_task_type::OBS_TASK_UI, false, [source]() {
 			// Do our WebSocket work.
-			nlohmann::json reply = nlohmann::json::object();
-			reply["source"]      = build_source_reference(source);
-			reply["signal"]      = "play";
-			reply["media"]       = build_source_media_metadata(source);
-
-			streamdeck::server::instance()->notify("obs.source.event.media", reply);
+			streamdeck::server::instance()->notify("obs.source.event.media", [&]() {
+				nlohmann::json reply = nlohmann::json::object();
+				reply["source"]      = build_source_reference(source);
+				reply["signal"]      = "play";
+				reply["media"]       = build_source_media_metadata(source);
+				return reply;
+			});
 		});
 	});
 
@@ -976,12 +983,13 @@ void streamdeck::handlers::obs_source::on_media_pause(void*, calldata_t* calldat
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(source);
-	reply["signal"]      = "pause";
-	reply["media"]       = build_source_media_metadata(source);
-
-	streamdeck::server::instance()->notify("obs.source.event.media", reply);
+	streamdeck::server::instance()->notify("obs.source.event.media", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(source);
+		reply["signal"]      = "pause";
+		reply["media"]       = build_source_media_metadata(source);
+		return reply;
+	});
 }
 
 void streamdeck::handlers::obs_source::on_media_restart(void*, calldata_t* calldata)
@@ -996,12 +1004,13 @@ void streamdeck::handlers::obs_source::on_media_restart(void*, calldata_t* calld
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(source);
-	reply["signal"]      = "restart";
-	reply["media"]       = build_source_media_metadata(source);
-
-	streamdeck::server::instance()->notify("obs.source.event.media", reply);
+	streamdeck::server::instance()->notify("obs.source.event.media", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(source);
+		reply["signal"]      = "restart";
+		reply["media"]       = build_source_media_metadata(source);
+		return reply;
+	});
 }
 
 void streamdeck::handlers::obs_source::on_media_stopped(void*, calldata_t* calldata)
@@ -1016,12 +1025,13 @@ void streamdeck::handlers::obs_source::on_media_stopped(void*, calldata_t* calld
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(source);
-	reply["signal"]      = "stopped";
-	reply["media"]       = build_source_media_metadata(source);
-
-	streamdeck::server::instance()->notify("obs.source.event.media", reply);
+	streamdeck::server::instance()->notify("obs.source.event.media", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(source);
+		reply["signal"]      = "stopped";
+		reply["media"]       = build_source_media_metadata(source);
+		return reply;
+	});
 }
 
 void streamdeck::handlers::obs_source::on_media_next(void*, calldata_t* calldata)
@@ -1036,12 +1046,13 @@ void streamdeck::handlers::obs_source::on_media_next(void*, calldata_t* calldata
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(source);
-	reply["signal"]      = "next";
-	reply["media"]       = build_source_media_metadata(source);
-
-	streamdeck::server::instance()->notify("obs.source.event.media", reply);
+	streamdeck::server::instance()->notify("obs.source.event.media", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(source);
+		reply["signal"]      = "next";
+		reply["media"]       = build_source_media_metadata(source);
+		return reply;
+	});
 }
 
 void streamdeck::handlers::obs_source::on_media_previous(void*, calldata_t* calldata)
@@ -1056,12 +1067,13 @@ void streamdeck::handlers::obs_source::on_media_previous(void*, calldata_t* call
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(source);
-	reply["signal"]      = "previous";
-	reply["media"]       = build_source_media_metadata(source);
-
-	streamdeck::server::instance()->notify("obs.source.event.media", reply);
+	streamdeck::server::instance()->notify("obs.source.event.media", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(source);
+		reply["signal"]      = "previous";
+		reply["media"]       = build_source_media_metadata(source);
+		return reply;
+	});
 }
 
 void streamdeck::handlers::obs_source::on_media_started(void*, calldata_t* calldata)
@@ -1076,12 +1088,13 @@ void streamdeck::handlers::obs_source::on_media_started(void*, calldata_t* calld
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(source);
-	reply["signal"]      = "started";
-	reply["media"]       = build_source_media_metadata(source);
-
-	streamdeck::server::instance()->notify("obs.source.event.media", reply);
+	streamdeck::server::instance()->notify("obs.source.event.media", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(source);
+		reply["signal"]      = "started";
+		reply["media"]       = build_source_media_metadata(source);
+		return reply;
+	});
 }
 
 void streamdeck::handlers::obs_source::on_media_ended(void*, calldata_t* calldata)
@@ -1096,12 +1109,13 @@ void streamdeck::handlers::obs_source::on_media_ended(void*, calldata_t* calldat
 	}
 
 	// Do our WebSocket work.
-	nlohmann::json reply = nlohmann::json::object();
-	reply["source"]      = build_source_reference(source);
-	reply["signal"]      = "ended";
-	reply["media"]       = build_source_media_metadata(source);
-
-	streamdeck::server::instance()->notify("obs.source.event.media", reply);
+	streamdeck::server::instance()->notify("obs.source.event.media", [&]() {
+		nlohmann::json reply = nlohmann::json::object();
+		reply["source"]      = build_source_reference(source);
+		reply["signal"]      = "ended";
+		reply["media"]       = build_source_media_metadata(source);
+		return reply;
+	});
 }
 
 void streamdeck::handlers::obs_source::enumerate(std::shared_ptr<streamdeck::jsonrpc::request>,
@@ -1124,10 +1138,11 @@ void streamdeck::handlers::obs_source::enumerate(std::shared_ptr<streamdeck::jso
 		},
 		&result);
 
-	res->set_result(result);
+	res->set_result(std::move(result));
 }
 
-void streamdeck::handlers::obs_source::state(std::shared_ptr<streamdeck::jsonrpc::request>  req,
+void streamdeck::handlers::obs_source::state(const source_state_params&                     params,
+											 std::shared_ptr<streamdeck::jsonrpc::request>,
 											 std::shared_ptr<streamdeck::jsonrpc::response> res)
 {
 	/** obs.source.state
@@ -1142,43 +1157,19 @@ void streamdeck::handlers::obs_source::state(std::shared_ptr<streamdeck::jsonrpc
 	 * @return {object} An object containing the current state of the source.
 	 */
 
-	nlohmann::json params;
-	if (!req->get_params(params)) {
-		throw jsonrpc::invalid_request_error("Method requires parameters.");
-	}
-
 	// Figure out which source we are modifying.
-	std::shared_ptr<obs_source_t> source;
-	{
-		auto p = params.find("source");
-		if (p != params.end()) {
-			source = resolve_source_reference(*p);
-			if (!source) {
-				throw jsonrpc::invalid_params_error("'source' does not exist.");
-			}
-		} else {
-			throw jsonrpc::invalid_params_error("'source' must be present.");
-		}
-	}
-
-	// Apply enabled state if present.
-	{
-		auto p = params.find("enabled");
-		if (p != params.end()) {
-			if (!p->is_boolean()) {
-				throw jsonrpc::invalid_params_error("'enabled' must be a Boolean.");
-			}
-
-			obs_source_set_enabled(source.get(), p->get<bool>());
-		}
+	std::shared_ptr<obs_source_t> source = resolve_source_reference(*params.source);
+	if (!source) {
+		throw jsonrpc::invalid_params_error("'source' does not exist.");
 	}
 
-	// Apply volume if present.
+	// Work out the new volume first, so that nothing is applied if it turns out to be invalid.
+	std::optional<float> volume;
 	{
-		auto p = params.find("volume");
-		if (p != params.end()) {
+		auto p = params.volume;
+		if (p) {
 			if (p->is_object()) {
-				auto o = p->get<nlohmann::json>();
+				auto const& o = *p;
 
 				auto  pValue = o.find("value");
 				float value  = 0.f;
@@ -1240,54 +1231,33 @@ void streamdeck::handlers::obs_source::state(std::shared_ptr<streamdeck::jsonrpc
 					vol = roundf(vol * 10.f) / 10.f;
 
 				}
-				vol = dbfs_to_value(vol);
-				obs_source_set_volume(source.get(), vol);
-			} else if (p->is_number()) {
-				float v = p->get<float>();
-				if ((v < 0.)) {
-					throw jsonrpc::invalid_params_error("'volume' can't be lower than 0.");
-				}
-
-				obs_source_set_volume(source.get(), v);
+				volume = dbfs_to_value(vol);
 			} else {
-				throw jsonrpc::invalid_params_error("'volume' must be a number or object.");
+				// A number, which the schema already checked the range of.
+				volume = p->get<float>();
 			}
 		}
 	}
 
-	// Apply muted state if present.
-	{
-		auto p = params.find("muted");
-		if (p != params.end()) {
-			if (!p->is_boolean()) {
-				throw jsonrpc::invalid_params_error("'muted' must be a Boolean.");
-			}
-
-			obs_source_set_muted(source.get(), p->get<bool>());
-		}
+	if (params.enabled) {
+		obs_source_set_enabled(source.get(), *params.enabled);
 	}
-
-	// Apply balance if present.
-	{
-		auto p = params.find("balance");
-		if (p != params.end()) {
-			if (!p->is_number()) {
-				throw jsonrpc::invalid_params_error("'balance' must be a number.");
-			}
-			float v = p->get<float>();
-			if ((v < 0.) || (v > 1.)) {
-				throw jsonrpc::invalid_params_error("'balance' can't be lower than 0 or higher than 1.");
-			}
-
-			obs_source_set_balance_value(source.get(), v);
-		}
+	if (volume) {
+		obs_source_set_volume(source.get(), *volume);
+	}
+	if (params.muted) {
+		obs_source_set_muted(source.get(), *params.muted);
+	}
+	if (params.balance) {
+		obs_source_set_balance_value(source.get(), static_cast<float>(*params.balance));
 	}
 
 	// Return the currently known information.
 	res->set_result(build_source_metadata(source.get()));
 }
 
-void streamdeck::handlers::obs_source::settings(std::shared_ptr<streamdeck::jsonrpc::request>  req,
+void streamdeck::handlers::obs_source::settings(const source_settings_params&                  params,
+												std::shared_ptr<streamdeck::jsonrpc::request>,
 												std::shared_ptr<streamdeck::jsonrpc::response> res)
 {
 	/** obs.source.settings
@@ -1299,31 +1269,8 @@ void streamdeck::handlers::obs_source::settings(std::shared_ptr<streamdeck::json
 	 * @return {object} An object containing the current settings of the source.
 	 */
 
-	// Validate parameters.
-	nlohmann::json parameters;
-	if (!req->get_params(parameters)) {
-		throw jsonrpc::invalid_params_error("Missing parameters.");
-	}
-
-	// - 'source'.
-	auto p_source = parameters.find("source");
-	if (p_source == parameters.end()) {
-		throw jsonrpc::invalid_params_error("Missing 'source' parameter.");
-	} else if (!(p_source->is_array() || p_source->is_string())) {
-		throw jsonrpc::invalid_params_error("Parameter 'source' must be a string or array.");
-	}
-
-	// - 'settings'.
-	auto p_settings = parameters.find("settings");
-	if (p_settings != parameters.end()) {
-		if (!(p_settings->is_array() || p_settings->is_object())) {
-			throw jsonrpc::invalid_params_error(
-				"Parameter 'settings' must either be an RFC 7386 object or an RFC 6902 array.");
-		}
-	}
-
 	// Try and resolve the source reference to an actual source.
-	auto source = resolve_source_reference(*p_source);
+	auto source = resolve_source_reference(*params.source);
 	if (!source) {
 		throw jsonrpc::invalid_params_error("Parameter 'source' does not describe an existing source.");
 	}
@@ -1332,29 +1279,29 @@ void streamdeck::handlers::obs_source::settings(std::shared_ptr<streamdeck::json
 	std::shared_ptr<obs_data_t> data{obs_source_get_settings(source.get()), [](obs_data_t* v) { obs_data_release(v); }};
 
 	// If settings are specified, update the source.
-	if (p_settings != parameters.end()) {
-		// Apply the patch.
-		auto original_data = nlohmann::json::parse(obs_data_get_json(data.get()));
-		auto patched_data  = original_data;
-		if (p_settings->is_object()) {
+	if (params.settings) {
+		// Apply the patch, reading it straight from the request.
+		auto const& patch    = *params.settings;
+		auto        settings = nlohmann::json::parse(obs_data_get_json(data.get()));
+		if (patch.is_object()) {
 			// RFC 7386: https://tools.ietf.org/html/rfc7386
 			try {
-				original_data.merge_patch(*p_settings);
+				settings.merge_patch(patch);
 			} catch (std::exception const& ex) {
 				throw jsonrpc::invalid_params_error(ex.what());
 			}
-		} else if (p_settings->is_array()) {
+		} else if (patch.is_array()) {
 			// RFC 6902: https://datatracker.ietf.org/doc/html/rfc6902
 			// RFC 6901: https://datatracker.ietf.org/doc/html/rfc6901
 			try {
-				patched_data = original_data.patch(*p_settings);
+				settings = settings.patch(patch);
 			} catch (std::exception const& ex) {
 				throw jsonrpc::invalid_params_error(ex.what());
 			}
 		}
 
 		// If the patch went without errors, update the source.
-		data = std::shared_ptr<obs_data_t>(obs_data_create_from_json(patched_data.dump().c_str()),
+		data = std::shared_ptr<obs_data_t>(obs_data_create_from_json(settings.dump().c_str()),
 										   [](obs_data_t* v) { obs_data_release(v); });
 		obs_source_update(source.get(), data.get());
 	}
@@ -1363,7 +1310,8 @@ void streamdeck::handlers::obs_source::settings(std::shared_ptr<streamdeck::json
 	res->set_result(nlohmann::json::parse(obs_data_get_json(data.get())));
 }
 
-void streamdeck::handlers::obs_source::media(std::shared_ptr<streamdeck::jsonrpc::request>  req,
+void streamdeck::handlers::obs_source::media(const source_media_params&                     params,
+											 std::shared_ptr<streamdeck::jsonrpc::request>,
 											 std::shared_ptr<streamdeck::jsonrpc::response> res)
 {
 	/** obs.source.media
@@ -1380,62 +1328,39 @@ void streamdeck::handlers::obs_source::media(std::shared_ptr<streamdeck::jsonrpc
 	// - state get
 	// - started get, ended get
 
-	nlohmann::json                args;
 	nlohmann::json                out;
-	std::shared_ptr<obs_source_t> source;
-
-	{ // Validate the request for all required information.
-		if (!req->get_params(args)) {
-			throw jsonrpc::invalid_params_error("No parameters.");
-		}
-
-		if (!args.contains("source")) {
-			throw jsonrpc::invalid_params_error("'source' not specified.");
-		}
-	}
-
-	if (args.contains("source")) { // Find Source
-		auto arg = args.find("source");
-		source   = resolve_source_reference(*arg);
-		if (!source) {
-			throw jsonrpc::invalid_params_error("'source' does not exist.");
-		}
-	}
-
-	if (args.contains("action")) {
-		auto arg = args.find("action");
-		if (!arg->is_string()) {
-			throw jsonrpc::invalid_params_error("'action' must be a string if provided.");
+	std::shared_ptr<obs_source_t> source = resolve_source_reference(*params.source);
+	if (!source) {
+		throw jsonrpc::invalid_params_error("'source' does not exist.");
+	}
+
+	if (params.action) {
+		std::string const& action = *params.action;
+		if (action == "play") {
+			obs_source_media_play_pause(source.get(), false);
+		} else if (action == "pause") {
+			obs_source_media_play_pause(source.get(), true);
+		} else if (action == "restart") {
+			obs_source_media_restart(source.get());
+		} else if (action == "stop") {
+			obs_source_media_stop(source.get());
+		} else if (action == "next") {
+			obs_source_media_next(source.get());
+		} else if (action == "previous") {
+			obs_source_media_previous(source.get());
 		} else {
-			std::string action = arg->get<std::string>();
-			if (action == "play") {
-				obs_source_media_play_pause(source.get(), false);
-			} else if (action == "pause") {
-				obs_source_media_play_pause(source.get(), true);
-			} else if (action == "restart") {
-				obs_source_media_restart(source.get());
-			} else if (action == "stop") {
-				obs_source_media_stop(source.get());
-			} else if (action == "next") {
-				obs_source_media_next(source.get());
-			} else if (action == "previous") {
-				obs_source_media_previous(source.get());
-			} else {
-				throw jsonrpc::invalid_params_error("'action' is not one of the accepted strings.");
-			}
+			throw jsonrpc::invalid_params_error("'action' is not one of the accepted strings.");
 		}
 	}
 
-	if (args.contains("time")) {
-		auto    arg      = args.find("time");
+	if (params.time) {
+		auto    arg      = params.time;
 		int64_t duration = obs_source_media_get_duration(source.get());
 		int64_t time     = 0;
 
-		if (!arg->is_number()) {
-			throw jsonrpc::invalid_params_error("'time' must be a number if provided.");
-		} else if (arg->is_number_float()) {
+		if (arg->is_number_float()) {
 			time = std::lroundf(arg->get<float>() * 1000.f);
-		} else if (arg->is_number_integer()) {
+		} else {
 			time = arg->get<int64_t>() * 1000;
 		}
 
@@ -1450,10 +1375,11 @@ void streamdeck::handlers::obs_source::media(std::shared_ptr<streamdeck::jsonrpc
 		out = build_source_metadata(source.get());
 	}
 
-	res->set_result(out);
+	res->set_result(std::move(out));
 }
 
-void streamdeck::handlers::obs_source::properties(std::shared_ptr<streamdeck::jsonrpc::request>  req,
+void streamdeck::handlers::obs_source::properties(const source_properties_params&                params,
+												  std::shared_ptr<streamdeck::jsonrpc::request>,
 												  std::shared_ptr<streamdeck::jsonrpc::response> res)
 {
 	/** obs.source.properties
@@ -1463,22 +1389,8 @@ void streamdeck::handlers::obs_source::properties(std::shared_ptr<streamdeck::js
 	 * @return {object} An object containing the current properties of the source.
 	 */
 
-	// Validate parameters.
-	nlohmann::json parameters;
-	if (!req->get_params(parameters)) {
-		throw jsonrpc::invalid_params_error("Missing parameters.");
-	}
-
-	// - 'source'.
-	auto p_source = parameters.find("source");
-	if (p_source == parameters.end()) {
-		throw jsonrpc::invalid_params_error("Missing 'source' parameter.");
-	} else if (!(p_source->is_array() || p_source->is_string())) {
-		throw jsonrpc::invalid_params_error("Parameter 'source' must be a string or array.");
-	}
-
 	// Try and resolve the source reference to an actual source.
-	auto source = resolve_source_reference(*p_source);
+	auto source = resolve_source_reference(*params.source);
 	if (!source) {
 		throw jsonrpc::invalid_params_error("Parameter 'source' does not describe an existing source.");
 	}
@@ -1503,33 +1415,19 @@ void streamdeck::handlers::obs_source::icons(std::shared_ptr<streamdeck::jsonrpc
 		}
 	}
 
-	res->set_result(result);
+	res->set_result(std::move(result));
 }
 
 
-void streamdeck::handlers::obs_source::filters(std::shared_ptr<streamdeck::jsonrpc::request>  req,
+void streamdeck::handlers::obs_source::filters(const source_filters_params&                   params,
+											   std::shared_ptr<streamdeck::jsonrpc::request>,
 											   std::shared_ptr<streamdeck::jsonrpc::response> res)
 {
-	// Validate parameters.
-	nlohmann::json parameters;
-	if (!req->get_params(parameters)) {
-		throw jsonrpc::invalid_params_error("Missing parameters.");
-	}
-
-	auto p_source = parameters.find("source");
-
-	if (p_source == parameters.end()) {
-		throw jsonrpc::invalid_params_error("'source' must be present.");
-	} else if (!p_source->is_string()) {
-		throw jsonrpc::invalid_params_error("'source' must be of type 'string'.");
-	}
-
 	// Try and find things in question.
 	std::shared_ptr<obs_source_t> source;
 
 	{ // Try and retrieve the described source from the name.
-		std::string name = p_source->get<std::string>();
-		source           = std::shared_ptr<obs_source_t>(obs_get_source_by_name(name.c_str()), obs_source_deleter);
+		source = std::shared_ptr<obs_source_t>(obs_get_source_by_name(params.source->c_str()), obs_source_deleter);
 		if (!source) {
 			throw jsonrpc::invalid_params_error("'source' does not describe an existing source.");
 		}
@@ -1545,5 +1443,5 @@ void streamdeck::handlers::obs_source::filters(std::shared_ptr<streamdeck::jsonr
 		},
 		&result);
 
-	res->set_result(result);
+	res->set_result(std::move(result));
 }
@@ -15,6 +15,7 @@
 
 #pragma once
 #include <memory>
+#include "handler-params.hpp"
 #include "json-rpc.hpp"
 
 #include <callback/signal.h>
@@ -61,20 +62,23 @@ namespace streamdeck {
 			void enumerate(std::shared_ptr<streamdeck::jsonrpc::request>,
 						   std::shared_ptr<streamdeck::jsonrpc::response>);
 
-			void state(std::shared_ptr<streamdeck::jsonrpc::request>, std::shared_ptr<streamdeck::jsonrpc::response>);
+			void state(const source_state_params&, std::shared_ptr<streamdeck::jsonrpc::request>,
+					   std::shared_ptr<streamdeck::jsonrpc::response>);
 
-			void settings(std::shared_ptr<streamdeck::jsonrpc::request>,
+			void settings(const source_settings_params&, std::shared_ptr<streamdeck::jsonrpc::request>,
 						  std::shared_ptr<streamdeck::jsonrpc::response>);
 
-			void media(std::shared_ptr<streamdeck::jsonrpc::request>, std::shared_ptr<streamdeck::jsonrpc::response>);
+			void media(const source_media_params&, std::shared_ptr<streamdeck::jsonrpc::request>,
+					   std::shared_ptr<streamdeck::jsonrpc::response>);
 
-			void properties(std::shared_ptr<streamdeck::jsonrpc::request>,
+			void properties(const source_properties_params&, std::shared_ptr<streamdeck::jsonrpc::request>,
 							std::shared_ptr<streamdeck::jsonrpc::response>);
 
 			void icons(std::shared_ptr<streamdeck::jsonrpc::request>, std::shared_ptr<streamdeck::jsonrpc::response>);
 
 			private /* Filters */:
-			void filters(std::shared_ptr<streamdeck::jsonrpc::request>, std::shared_ptr<streamdeck::jsonrpc::response>);
+			void filters(const source_filters_params&, std::shared_ptr<streamdeck::jsonrpc::request>,
+						 std::shared_ptr<streamdeck::jsonrpc::response>);
 
 		};
 
@@ -0,0 +1,229 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <limits>
+#include <optional>
+#include <string>
+#include "param-schema.hpp"
+
+// The params of the handlers which declare them, kept apart from the handlers so that they don't depend on libobs.
+// Declare a method next to its fields with params::method, and register the handler through it.
+
+namespace streamdeck {
+	namespace handlers {
+		/* obs.source.* */
+		struct source_state_params {
+			const nlohmann::json* source;
+			std::optional<bool>   enabled;
+			const nlohmann::json* volume;
+			std::optional<bool>   muted;
+			std::optional<double> balance;
+		};
+
+		inline constexpr params::field<source_state_params> source_state_fields[] = {
+			params::value("source", params::STRING | params::ARRAY, &source_state_params::source,
+						  "The source (or source + filter) to check or change the state of.")
+				.require(),
+			params::boolean("enabled", &source_state_params::enabled, "`true` to enable, `false` to disable."),
+			params::value("volume", params::NUMBER | params::OBJECT, &source_state_params::volume,
+						  "Volume as a factor, or an object with a relative `value` in `unit` ('%' or 'dB').")
+				.range(0., std::numeric_limits<double>::max()),
+			params::boolean("muted", &source_state_params::muted, "`true` to mute, `false` to unmute."),
+			params::number("balance", &source_state_params::balance, "Balance from 0.00 (left) to 1.00 (right).")
+				.range(0., 1.),
+		};
+		inline const params::method source_state_method("obs.source.state", source_state_fields);
+
+		struct source_settings_params {
+			const nlohmann::json* source;
+			const nlohmann::json* settings;
+		};
+
+		inline constexpr params::field<source_settings_params> source_settings_fields[] = {
+			params::value("source", params::STRING | params::ARRAY, &source_settings_params::source,
+						  "The source (or source + filter) to check or change the settings of.")
+				.require(),
+			params::value("settings", params::ARRAY | params::OBJECT, &source_settings_params::settings,
+						  "An RFC 6902 array or RFC 7386 object to patch the settings of the source with."),
+		};
+		inline const params::method source_settings_method("obs.source.settings", source_settings_fields);
+
+		struct source_media_params {
+			const nlohmann::json*      source;
+			std::optional<std::string> action;
+			const nlohmann::json*      time;
+		};
+
+		inline constexpr params::field<source_media_params> source_media_fields[] = {
+			params::value("source", params::STRING | params::ARRAY, &source_media_params::source,
+						  "The source (or source + filter) to control media on.")
+				.require(),
+			params::string("action", &source_media_params::action,
+						   "One of 'play', 'pause', 'restart', 'stop', 'next', 'previous'."),
+			params::value("time", params::NUMBER, &source_media_params::time, "Time to seek to, in seconds."),
+		};
+		inline const params::method source_media_method("obs.source.media", source_media_fields);
+
+		struct source_properties_params {
+			const nlohmann::json* source;
+		};
+
+		inline constexpr params::field<source_properties_params> source_properties_fields[] = {
+			params::value("source", params::STRING | params::ARRAY, &source_properties_params::source,
+						  "The source (or source + filter) to list the properties of.")
+				.require(),
+		};
+		inline const params::method source_properties_method("obs.source.properties", source_properties_fields);
+
+		struct source_filters_params {
+			std::optional<std::string> source;
+		};
+
+		inline constexpr params::field<source_filters_params> source_filters_fields[] = {
+			params::string("source", &source_filters_params::source, "The source to list the filters of.").require(),
+		};
+		inline const params::method source_filters_method("obs.source.filters", source_filters_fields);
+
+		/* obs.scene.* */
+		struct scene_items_params {
+			std::optional<std::string> scene;
+		};
+
+		inline constexpr params::field<scene_items_params> scene_items_fields[] = {
+			params::string("scene", &scene_items_params::scene, "The name of the scene to enumerate items for.")
+				.require(),
+		};
+		inline const params::method scene_items_method("obs.scene.items", scene_items_fields);
+
+		struct scene_item_visible_params {
+			const nlohmann::json* item;
+			std::optional<bool>   visible;
+		};
+
+		inline constexpr params::field<scene_item_visible_params> scene_item_visible_fields[] = {
+			params::value("item", params::ARRAY, &scene_item_visible_params::item,
+						  "The reference to the item in question, as an Array(String, String, Number).")
+				.require(),
+			params::boolean("visible", &scene_item_visible_params::visible,
+							"`true` to make the item visible, `false` to make it invisible."),
+		};
+		inline const params::method scene_item_visible_method("obs.scene.item.visible", scene_item_visible_fields);
+
+		/* obs.frontend.* */
+		struct frontend_studiomode_params {
+			std::optional<bool> enabled;
+		};
+
+		inline constexpr params::field<frontend_studiomode_params> frontend_studiomode_fields[] = {
+			params::boolean("enabled", &frontend_studiomode_params::enabled,
+							"`true` to enable studio mode, or `false` to disable it."),
+		};
+		inline const params::method frontend_studiomode_method("obs.frontend.studiomode", frontend_studiomode_fields);
+
+		struct frontend_scenecollection_params {
+			std::optional<std::string> collection;
+		};
+
+		inline constexpr params::field<frontend_scenecollection_params> frontend_scenecollection_fields[] = {
+			params::string("collection", &frontend_scenecollection_params::collection,
+						   "Name of the scene collection to switch to."),
+		};
+		inline const params::method frontend_scenecollection_method("obs.frontend.scenecollection",
+																	 frontend_scenecollection_fields);
+
+		struct frontend_profile_params {
+			std::optional<std::string> profile;
+		};
+
+		inline constexpr params::field<frontend_profile_params> frontend_profile_fields[] = {
+			params::string("profile", &frontend_profile_params::profile, "Name of the profile to switch to."),
+		};
+		inline const params::method frontend_profile_method("obs.frontend.profile", frontend_profile_fields);
+
+		struct frontend_scene_params {
+			std::optional<bool>        program;
+			std::optional<std::string> scene;
+		};
+
+		inline constexpr params::field<frontend_scene_params> frontend_scene_fields[] = {
+			params::boolean("program", &frontend_scene_params::program,
+							"`true` to target 'Program', `false` to target 'Preview'. Default is `false`."),
+			params::string("scene", &frontend_scene_params::scene, "Name of the scene to switch to."),
+		};
+		inline const params::method frontend_scene_method("obs.frontend.scene", frontend_scene_fields);
+
+		/* obs.* */
+		struct subscribe_params {
+			const nlohmann::json* events;
+			const nlohmann::json* sources;
+		};
+
+		inline constexpr params::field<subscribe_params> subscribe_fields[] = {
+			params::value("events", params::ARRAY, &subscribe_params::events,
+						  "Notification method names (strings) to receive, '*' matches any sequence of characters.")
+				.require(),
+			params::value("sources", params::ARRAY, &subscribe_params::sources,
+						  "Only receive these notifications for the given sources and scenes (strings)."),
+		};
+		inline const params::method subscribe_method("obs.subscribe", subscribe_fields);
+
+		struct unsubscribe_params {
+			const nlohmann::json* events;
+		};
+
+		inline constexpr params::field<unsubscribe_params> unsubscribe_fields[] = {
+			params::value("events", params::ARRAY, &unsubscribe_params::events,
+						  "Patterns (strings) previously passed to obs.subscribe. Removes all if omitted."),
+		};
+		inline const params::method unsubscribe_method("obs.unsubscribe", unsubscribe_fields);
+
+		struct session_resume_params {
+			std::optional<std::string> session;
+			std::optional<int64_t>     seq;
+		};
+
+		inline constexpr params::field<session_resume_params> session_resume_fields[] = {
+			params::string("session", &session_resume_params::session,
+						   "Session returned by an earlier call. Omit to only learn the current one."),
+			params::integer("seq", &session_resume_params::seq, "Sequence number of the last notification received.")
+				.range(0., std::numeric_limits<double>::max()),
+		};
+		inline const params::method session_resume_method("obs.session.resume", session_resume_fields);
+
+		struct watch_params {
+			std::optional<std::string> method;
+			const nlohmann::json*      params;
+		};
+
+		inline constexpr params::field<watch_params> watch_fields[] = {
+			params::string("method", &watch_params::method, "Query to watch, see the list of watchable methods.")
+				.require(),
+			params::value("params", params::OBJECT, &watch_params::params, "Parameters to call it with."),
+		};
+		inline const params::method watch_method("obs.watch", watch_fields);
+
+		struct unwatch_params {
+			std::optional<int64_t> watch;
+		};
+
+		inline constexpr params::field<unwatch_params> unwatch_fields[] = {
+			params::integer("watch", &unwatch_params::watch, "Id returned by obs.watch.")
+				.require()
+				.range(0., std::numeric_limits<double>::max()),
+		};
+		inline const params::method unwatch_method("obs.unwatch", unwatch_fields);
+	} // namespace handlers
+} // namespace streamdeck
@@ -45,6 +45,54 @@ streamdeck::handlers::system::system()
 	server->handle("ping", std::bind(&streamdeck::handlers::system::_ping, this, std::placeholders::_1));
 	server->handle_sync("version", std::bind(&streamdeck::handlers::system::_version, this, std::placeholders::_1,
 											 std::placeholders::_2));
+	server->handle_sync(subscribe_method,
+						std::bind(&streamdeck::handlers::system::_subscribe, this, std::placeholders::_1,
+								  std::placeholders::_2, std::placeholders::_3));
+	server->handle_sync(unsubscribe_method,
+						std::bind(&streamdeck::handlers::system::_unsubscribe, this, std::placeholders::_1,
+								  std::placeholders::_2, std::placeholders::_3));
+	server->handle_sync("obs.system.metrics", std::bind(&streamdeck::handlers::system::_metrics, this,
+														std::placeholders::_1, std::placeholders::_2));
+	server->handle_sync("obs.system.methods", std::bind(&streamdeck::handlers::system::_methods, this,
+														std::placeholders::_1, std::placeholders::_2));
+	server->handle_sync(session_resume_method,
+						std::bind(&streamdeck::handlers::system::_session_resume, this, std::placeholders::_1,
+								  std::placeholders::_2, std::placeholders::_3));
+	server->handle_sync(watch_method,
+						std::bind(&streamdeck::handlers::system::_watch, this, std::placeholders::_1,
+								  std::placeholders::_2, std::placeholders::_3));
+	server->handle_sync(unwatch_method,
+						std::bind(&streamdeck::handlers::system::_unwatch, this, std::placeholders::_1,
+								  std::placeholders::_2, std::placeholders::_3));
+}
+
+static nlohmann::json build_subscriptions(std::shared_ptr<const streamdeck::jsonrpc::subscriptions> subs)
+{
+	nlohmann::json result = nlohmann::json::array();
+	if (subs) {
+		for (auto const& entry : subs->entries()) {
+			nlohmann::json o = nlohmann::json::object();
+			o["event"]       = entry.pattern;
+			o["sources"]     = entry.sources;
+			result.push_back(o);
+		}
+	}
+	return result;
+}
+
+static std::vector<std::string> parse_string_array(nlohmann::json const& value, const char* error)
+{
+	std::vector<std::string> result;
+	if (!value.is_array()) {
+		throw streamdeck::jsonrpc::invalid_params_error(error);
+	}
+	for (auto const& entry : value) {
+		if (!entry.is_string()) {
+			throw streamdeck::jsonrpc::invalid_params_error(error);
+		}
+		result.push_back(entry.get<std::string>());
+	}
+	return result;
 }
 
 std::shared_ptr<streamdeck::jsonrpc::response>
@@ -56,14 +104,15 @@ std::shared_ptr<streamdeck::jsonrpc::response>
 void streamdeck::handlers::system::_version(std::shared_ptr<streamdeck::jsonrpc::request>  req,
 											std::shared_ptr<streamdeck::jsonrpc::response> res)
 {
-	nlohmann::json params;
-	if (!req->get_params(params)) {
+	auto const& params = req->get_params();
+	if (params.is_null()) {
 		throw jsonrpc::invalid_request_error("Method requires parameters.");
 	}
-	if (params.is_object() && params["version"].is_string()) {
+	auto p_version = params.find("version");
+	if ((p_version != params.end()) && p_version->is_string()) {
 		auto client = req->get_client();
 		if (client) {
-			client->set_version(params["version"]);
+			client->set_version(p_version->get<std::string>());
 		}
 	}
 
@@ -73,6 +122,150 @@ void streamdeck::handlers::system::_version(std::shared_ptr<streamdeck::jsonrpc:
 	result["obsver"]      = obs_get_version();
 	result["obsverstr"] = obs_get_version_string();
 	
-	res->set_result(result);
+	res->set_result(std::move(result));
+
+}
+
+void streamdeck::handlers::system::_subscribe(const subscribe_params&                        params,
+											  std::shared_ptr<streamdeck::jsonrpc::request>  req,
+											  std::shared_ptr<streamdeck::jsonrpc::response> res)
+{
+	/** obs.subscribe
+	 *
+	 * @param events {Array(string)} Notification method names to receive, '*' matches any sequence of characters.
+	 * @param sources {Array(string)} [Optional] Only receive these notifications for the given sources and scenes.
+	 *
+	 * @return {Array(object)} The current subscriptions of this client.
+	 */
+
+	auto client = req->get_client();
+	if (!client) {
+		throw jsonrpc::internal_error("Request is not associated with a client.");
+	}
+
+	auto events = parse_string_array(*params.events, "'events' must be an array of strings.");
+
+	std::set<std::string> sources;
+	if (params.sources) {
+		for (auto const& source : parse_string_array(*params.sources, "'sources' must be an array of strings.")) {
+			sources.insert(source);
+		}
+	}
+
+	// Subscriptions are read from other threads, so always replace them as a whole.
+	auto current = client->get_subscriptions();
+	auto updated = current ? std::make_shared<jsonrpc::subscriptions>(*current)
+						   : std::make_shared<jsonrpc::subscriptions>();
+	for (auto const& event : events) {
+		updated->add(event, sources);
+	}
+	client->set_subscriptions(updated);
+
+	res->set_result(build_subscriptions(updated));
+}
+
+void streamdeck::handlers::system::_unsubscribe(const unsubscribe_params&                      params,
+												std::shared_ptr<streamdeck::jsonrpc::request>  req,
+												std::shared_ptr<streamdeck::jsonrpc::response> res)
+{
+	/** obs.unsubscribe
+	 *
+	 * @param events {Array(string)} [Optional] Patterns previously passed to obs.subscribe. Removes all if omitted.
+	 *
+	 * @return {Array(object)} The remaining subscriptions of this client.
+	 */
+
+	auto client = req->get_client();
+	if (!client) {
+		throw jsonrpc::internal_error("Request is not associated with a client.");
+	}
+
+	auto current = client->get_subscriptions();
+	auto updated = current ? std::make_shared<jsonrpc::subscriptions>(*current)
+						   : std::make_shared<jsonrpc::subscriptions>();
+
+	if (params.events) {
+		for (auto const& event : parse_string_array(*params.events, "'events' must be an array of strings.")) {
+			updated->remove(event);
+		}
+	} else {
+		updated->clear();
+	}
+	client->set_subscriptions(updated);
+
+	res->set_result(build_subscriptions(updated));
+}
+
+void streamdeck::handlers::system::_metrics(std::shared_ptr<streamdeck::jsonrpc::request>,
+											std::shared_ptr<streamdeck::jsonrpc::response> res)
+{
+	/** obs.system.metrics
+	 *
+	 * @return {object} Latency histograms per method, transport counters and notification statistics.
+	 */
+
+	res->set_result(streamdeck::server::instance()->get_metrics());
+}
+
+void streamdeck::handlers::system::_methods(std::shared_ptr<streamdeck::jsonrpc::request>,
+											std::shared_ptr<streamdeck::jsonrpc::response> res)
+{
+	/** obs.system.methods
+	 *
+	 * @return {object} Every method by name, with the params of those which declare them.
+	 */
+
+	res->set_result(streamdeck::server::instance()->describe_methods());
+}
+
+void streamdeck::handlers::system::_session_resume(const session_resume_params&                   params,
+												   std::shared_ptr<streamdeck::jsonrpc::request>  req,
+												   std::shared_ptr<streamdeck::jsonrpc::response> res)
+{
+	/** obs.session.resume
+	 *
+	 * @param session {string} [Optional] Session returned by an earlier call. Omit to only learn the current one.
+	 * @param seq {integer} [Optional] Sequence number of the last notification received.
+	 *
+	 * @return {object} The current session and sequence number, and the missed notifications unless a resync is
+	 *                  required.
+	 */
+
+	auto client = req->get_client();
+	if (!client) {
+		throw jsonrpc::internal_error("Request is not associated with a client.");
+	}
+
+	res->set_result(streamdeck::server::instance()->resume(*client, params.session.value_or(""),
+														   static_cast<uint64_t>(params.seq.value_or(0))));
+}
+
+void streamdeck::handlers::system::_watch(const watch_params&                            params,
+										  std::shared_ptr<streamdeck::jsonrpc::request>  req,
+										  std::shared_ptr<streamdeck::jsonrpc::response> res)
+{
+	/** obs.watch
+	 *
+	 * @param method {string} Query to watch, see the list of watchable methods.
+	 * @param params {object} [Optional] Parameters to call it with.
+	 *
+	 * @return {object} The id of the watch, along with the current result or error of the query.
+	 */
+
+	res->set_result(streamdeck::server::instance()->watch(req->get_handle(), *params.method,
+														  params.params ? *params.params : nlohmann::json()));
+}
+
+void streamdeck::handlers::system::_unwatch(const unwatch_params&                          params,
+											std::shared_ptr<streamdeck::jsonrpc::request>  req,
+											std::shared_ptr<streamdeck::jsonrpc::response> res)
+{
+	/** obs.unwatch
+	 *
+	 * @param watch {integer} Id returned by obs.watch.
+	 *
+	 * @return {bool} `true` if the watch was removed, `false` if this connection has no such watch.
+	 */
 
+	res->set_result(streamdeck::server::instance()->unwatch(req->get_handle(), static_cast<uint64_t>(*params.watch)));
 }
@@ -15,6 +15,7 @@
 
 #pragma once
 #include <memory>
+#include "handler-params.hpp"
 #include "json-rpc.hpp"
 
 namespace streamdeck {
@@ -31,6 +32,31 @@ namespace streamdeck {
 
 			void _version(std::shared_ptr<streamdeck::jsonrpc::request>  req,
 						  std::shared_ptr<streamdeck::jsonrpc::response> res);
+
+			void _subscribe(const subscribe_params&                        params,
+							std::shared_ptr<streamdeck::jsonrpc::request>  req,
+							std::shared_ptr<streamdeck::jsonrpc::response> res);
+			void _unsubscribe(const unsubscribe_params&                      params,
+							  std::shared_ptr<streamdeck::jsonrpc::request>  req,
+							  std::shared_ptr<streamdeck::jsonrpc::response> res);
+
+			void _metrics(std::shared_ptr<streamdeck::jsonrpc::request>  req,
+						  std::shared_ptr<streamdeck::jsonrpc::response> res);
+
+			void _methods(std::shared_ptr<streamdeck::jsonrpc::request>  req,
+						  std::shared_ptr<streamdeck::jsonrpc::response> res);
+
+			void _session_resume(const session_resume_params&                   params,
+								 std::shared_ptr<streamdeck::jsonrpc::request>  req,
+								 std::shared_ptr<streamdeck::jsonrpc::response> res);
+
+			void _watch(const watch_params&                            params,
+						std::shared_ptr<streamdeck::jsonrpc::request>  req,
+						std::shared_ptr<streamdeck::jsonrpc::response> res);
+
+			void _unwatch(const unwatch_params&                          params,
+						  std::shared_ptr<streamdeck::jsonrpc::request>  req,
+						  std::shared_ptr<streamdeck::jsonrpc::response> res);
 		};
 	} // namespace handlers
 } // namespace streamdeck
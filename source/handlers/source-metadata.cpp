@@ -0,0 +1,93 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "source-metadata.hpp"
+
+static nlohmann::json string_or_null(const char* value)
+{
+	return value ? nlohmann::json(value) : nlohmann::json();
+}
+
+nlohmann::json streamdeck::handlers::build_flags_metadata(uint32_t flags, const flag_names_t& names)
+{
+	auto res = nlohmann::json::object();
+	for (auto const& kv : names) {
+		res[kv.second] = (flags & kv.first) ? true : false;
+	}
+	return res;
+}
+
+nlohmann::json streamdeck::handlers::source_media_metadata::to_json() const
+{
+	nlohmann::json res = nlohmann::json::object();
+	res["status"]      = string_or_null(status);
+
+	{
+		auto o = nlohmann::json::array();
+		o.push_back(time);
+		o.push_back(duration);
+		res["time"] = std::move(o);
+	}
+
+	return res;
+}
+
+nlohmann::json streamdeck::handlers::source_metadata::to_json(const flag_names_t& output_flag_names,
+															  const flag_names_t& flag_names) const
+{
+	nlohmann::json res = nlohmann::json::object();
+
+	// The current name of the source.
+	res["id"]             = id ? id : "";
+	res["id_unversioned"] = id_unversioned ? id_unversioned : "";
+	res["name"]           = name ? name : "";
+	res["type"]           = string_or_null(type);
+
+	res["enabled"] = enabled;
+	res["active"]  = active;
+	res["visible"] = visible;
+
+	{ // Output Flags
+		auto o              = build_flags_metadata(output_flags, output_flag_names);
+		res["outputflags"]  = o; // Deprecated
+		res["output_flags"] = std::move(o);
+	}
+
+	{ // Size and Base Size
+		auto o = nlohmann::json::array();
+		o.push_back(width);
+		o.push_back(height);
+		o.push_back(base_width);
+		o.push_back(base_height);
+		res["size"] = std::move(o);
+	}
+
+	res["flags"] = build_flags_metadata(flags, flag_names);
+
+	{ // Audio
+		auto o           = nlohmann::json::object();
+		o["layout"]      = string_or_null(audio.layout);
+		o["muted"]       = audio.muted;
+		o["volume"]      = audio.volume;
+		o["balance"]     = audio.balance;
+		o["sync_offset"] = audio.sync_offset;
+		o["mixers"]      = audio.mixers;
+		res["audio"]     = std::move(o);
+	}
+
+	res["media"] = media.to_json();
+
+	return res;
+}
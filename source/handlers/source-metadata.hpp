@@ -0,0 +1,71 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+namespace streamdeck {
+	namespace handlers {
+		typedef std::map<uint32_t, std::string> flag_names_t;
+
+		// Every named flag, set or not, as an object of booleans.
+		nlohmann::json build_flags_metadata(uint32_t flags, const flag_names_t& names);
+
+		// Values read from a media source, as reported in 'media'.
+		struct source_media_metadata {
+			const char* status = nullptr; // nullptr if the state is unknown.
+			int64_t     time     = 0;
+			int64_t     duration = 0;
+
+			nlohmann::json to_json() const;
+		};
+
+		// Values read from an obs_source_t, as reported in 'state' by obs.source.* and in the source events.
+		//
+		// Kept free of libobs so that the shape of the output can be checked on its own.
+		struct source_metadata {
+			const char* id             = nullptr;
+			const char* id_unversioned = nullptr;
+			const char* name           = nullptr;
+			const char* type           = nullptr; // nullptr if the type is unknown.
+			bool        enabled        = false;
+			bool        active         = false;
+			bool        visible        = false;
+			uint32_t    output_flags   = 0;
+			uint32_t    flags          = 0;
+			uint32_t    width          = 0;
+			uint32_t    height         = 0;
+			uint32_t    base_width     = 0;
+			uint32_t    base_height    = 0;
+
+			struct {
+				const char* layout      = nullptr; // nullptr if the speaker layout is unknown.
+				bool        muted       = false;
+				float       volume      = 0.f;
+				float       balance     = 0.f;
+				int64_t     sync_offset = 0;
+				uint32_t    mixers      = 0;
+			} audio;
+
+			source_media_metadata media;
+
+			nlohmann::json to_json(const flag_names_t& output_flag_names, const flag_names_t& flag_names) const;
+		};
+	} // namespace handlers
+} // namespace streamdeck
@@ -25,8 +25,10 @@
 // POSSIBILITY OF SUCH DAMAGE.
 
 #include "json-rpc.hpp"
+#include <algorithm>
 
 #define PROTOCOL_ID "2.0"
+#define TIMEOUT_MAX_MS 86400000
 
 #define VALIDATION_JSONRPC_MISSING "'jsonrpc' is missing"
 #define VALIDATION_JSONRPC_TYPE "'jsonrpc' has wrong type"
@@ -36,6 +38,7 @@
 #define VALIDATION_REQUEST_METHOD_MISSING "'method' is missing"
 #define VALIDATION_REQUEST_METHOD_TYPE "'method' has wrong type"
 #define VALIDATION_REQUEST_PARAMS_TYPE "'params' has wrong type"
+#define VALIDATION_REQUEST_TIMEOUT_TYPE "'timeout' must be a non-negative integer"
 #define VALIDATION_RESPONSE_MISSING "'result' and 'error' are missing"
 #define VALIDATION_RESPONSE_MALFORMED "'result' and 'error' can't coexist"
 #define VALIDATION_RESPONSE_ERROR_TYPE "'error' has wrong type"
@@ -67,7 +70,7 @@ void rpc_validate(nlohmann::json& json)
 
 streamdeck::jsonrpc::jsonrpc::~jsonrpc() {}
 
-streamdeck::jsonrpc::jsonrpc::jsonrpc() : _json(nlohmann::json::object())
+streamdeck::jsonrpc::jsonrpc::jsonrpc() : _json(nlohmann::json::object()), _client(nullptr)
 {
 	_json["jsonrpc"] = PROTOCOL_ID;
 }
@@ -128,14 +131,19 @@ nlohmann::json streamdeck::jsonrpc::jsonrpc::compile()
 	return _json;
 }
 
+nlohmann::json streamdeck::jsonrpc::jsonrpc::release()
+{
+	validate();
+	return std::move(_json);
+}
+
 streamdeck::jsonrpc::jsonrpc& streamdeck::jsonrpc::jsonrpc::copy_id(streamdeck::jsonrpc::jsonrpc& other)
 {
-	nlohmann::json id;
-	auto           id_obj = other._json.find("id");
+	auto id_obj = other._json.find("id");
 	if (id_obj != other._json.end()) {
-		id_obj->get_to(id);
-		_json["id"] = id;
+		_json["id"] = *id_obj;
 	}
+	_call = other._call;
 	return *this;
 }
 
@@ -143,6 +151,17 @@ streamdeck::jsonrpc::client* streamdeck::jsonrpc::jsonrpc::get_client() {
 	return _client;
 }
 
+streamdeck::jsonrpc::jsonrpc& streamdeck::jsonrpc::jsonrpc::set_call(std::shared_ptr<streamdeck::call_state> value)
+{
+	_call = std::move(value);
+	return *this;
+}
+
+const std::shared_ptr<streamdeck::call_state>& streamdeck::jsonrpc::jsonrpc::get_call() const
+{
+	return _call;
+}
+
 streamdeck::jsonrpc::request::~request() {}
 
 streamdeck::jsonrpc::request::request()
@@ -150,13 +169,24 @@ streamdeck::jsonrpc::request::request()
 	_json["method"] = "";
 }
 
-streamdeck::jsonrpc::request::request(nlohmann::json& json, client* c = nullptr)
+streamdeck::jsonrpc::request::request(nlohmann::json json, client* c)
 {
-	_json = json;
+	_json = std::move(json);
 	_client = c;
 	validate();
 }
 
+streamdeck::jsonrpc::request& streamdeck::jsonrpc::request::set_handle(std::weak_ptr<void> value)
+{
+	_handle = std::move(value);
+	return *this;
+}
+
+const std::weak_ptr<void>& streamdeck::jsonrpc::request::get_handle() const
+{
+	return _handle;
+}
+
 streamdeck::jsonrpc::request& streamdeck::jsonrpc::request::set_method(const std::string& value)
 {
 	_json["method"] = value;
@@ -192,7 +222,7 @@ streamdeck::jsonrpc::request& streamdeck::jsonrpc::request::clear_params()
 
 streamdeck::jsonrpc::request& streamdeck::jsonrpc::request::set_params(nlohmann::json value)
 {
-	_json["params"] = value;
+	_json["params"] = std::move(value);
 	return *this;
 }
 
@@ -206,6 +236,28 @@ bool streamdeck::jsonrpc::request::get_params(nlohmann::json& value)
 	return false;
 }
 
+const nlohmann::json& streamdeck::jsonrpc::request::get_params() const
+{
+	static const nlohmann::json none;
+
+	auto params_obj = _json.find("params");
+	if ((params_obj != _json.end())) {
+		return *params_obj;
+	}
+	return none;
+}
+
+bool streamdeck::jsonrpc::request::get_timeout(std::chrono::milliseconds& value)
+{
+	auto timeout_obj = _json.find("timeout");
+	if ((timeout_obj != _json.end()) && timeout_obj->is_number_unsigned()) {
+		// Waiting any longer is no different from waiting forever, and the deadline must not overflow.
+		value = std::chrono::milliseconds(std::min<uint64_t>(timeout_obj->get<uint64_t>(), TIMEOUT_MAX_MS));
+		return true;
+	}
+	return false;
+}
+
 void streamdeck::jsonrpc::request::validate()
 {
 	rpc_validate(_json);
@@ -223,6 +275,12 @@ void streamdeck::jsonrpc::request::validate()
 		if (!params_obj->is_structured())
 			throw streamdeck::jsonrpc::parse_error(VALIDATION_REQUEST_PARAMS_TYPE);
 	}
+
+	auto timeout_obj = _json.find("timeout");
+	if (timeout_obj != _json.end()) {
+		if (!timeout_obj->is_number_unsigned())
+			throw streamdeck::jsonrpc::parse_error(VALIDATION_REQUEST_TIMEOUT_TYPE);
+	}
 }
 
 streamdeck::jsonrpc::response::~response() {}
@@ -232,9 +290,9 @@ streamdeck::jsonrpc::response::response()
 	_json["result"] = 0;
 }
 
-streamdeck::jsonrpc::response::response(nlohmann::json& json, client* c)
+streamdeck::jsonrpc::response::response(nlohmann::json json, client* c)
 {
-	_json = json;
+	_json = std::move(json);
 	_client = c;
 	validate();
 }
@@ -242,7 +300,7 @@ streamdeck::jsonrpc::response::response(nlohmann::json& json, client* c)
 streamdeck::jsonrpc::response& streamdeck::jsonrpc::response::set_result(nlohmann::json value)
 {
 	_json.erase("error");
-	_json["result"] = value;
+	_json["result"] = std::move(value);
 	return *this;
 }
 
@@ -263,7 +321,7 @@ streamdeck::jsonrpc::response& streamdeck::jsonrpc::response::set_error(int64_t
 	nlohmann::json error_obj = nlohmann::json::object();
 	error_obj["code"]        = code;
 	error_obj["message"]     = message;
-	_json["error"]           = error_obj;
+	_json["error"]           = std::move(error_obj);
 
 	return *this;
 }
@@ -276,8 +334,8 @@ streamdeck::jsonrpc::response& streamdeck::jsonrpc::response::set_error(int64_t
 	nlohmann::json error_obj = nlohmann::json::object();
 	error_obj["code"]        = code;
 	error_obj["message"]     = message;
-	error_obj["data"]        = data;
-	_json["error"]           = error_obj;
+	error_obj["data"]        = std::move(data);
+	_json["error"]           = std::move(error_obj);
 
 	return *this;
 }
@@ -376,3 +434,105 @@ std::string streamdeck::jsonrpc::client::get_version() const
 {
 	return _remote_version;
 }
+
+void streamdeck::jsonrpc::client::set_subscriptions(std::shared_ptr<const subscriptions> value)
+{
+	std::atomic_store(&_subscriptions, value);
+}
+
+std::shared_ptr<const streamdeck::jsonrpc::subscriptions> streamdeck::jsonrpc::client::get_subscriptions() const
+{
+	return std::atomic_load(&_subscriptions);
+}
+
+bool streamdeck::jsonrpc::client::is_subscribed(const std::string&              method,
+												const std::vector<std::string>& sources) const
+{
+	auto subs = get_subscriptions();
+	if (!subs) {
+		return true;
+	}
+	return subs->matches(method, sources);
+}
+
+static bool match_pattern(const char* pattern, const char* text)
+{
+	// Plain glob matching, '*' matches any (possibly empty) sequence of characters.
+	const char* star  = nullptr;
+	const char* retry = nullptr;
+	while (*text) {
+		if (*pattern == '*') {
+			star  = pattern++;
+			retry = text;
+		} else if (*pattern == *text) {
+			pattern++;
+			text++;
+		} else if (star) {
+			pattern = star + 1;
+			text    = ++retry;
+		} else {
+			return false;
+		}
+	}
+	while (*pattern == '*') {
+		pattern++;
+	}
+	return *pattern == '\0';
+}
+
+streamdeck::jsonrpc::subscriptions& streamdeck::jsonrpc::subscriptions::add(const std::string&           pattern,
+																			 const std::set<std::string>& sources)
+{
+	for (auto& entry : _entries) {
+		if (entry.pattern == pattern) {
+			entry.sources = sources;
+			return *this;
+		}
+	}
+	_entries.push_back({pattern, sources});
+	return *this;
+}
+
+streamdeck::jsonrpc::subscriptions& streamdeck::jsonrpc::subscriptions::remove(const std::string& pattern)
+{
+	for (auto iter = _entries.begin(); iter != _entries.end();) {
+		if (iter->pattern == pattern) {
+			iter = _entries.erase(iter);
+		} else {
+			iter++;
+		}
+	}
+	return *this;
+}
+
+streamdeck::jsonrpc::subscriptions& streamdeck::jsonrpc::subscriptions::clear()
+{
+	_entries.clear();
+	return *this;
+}
+
+bool streamdeck::jsonrpc::subscriptions::matches(const std::string&              method,
+												 const std::vector<std::string>& sources) const
+{
+	for (auto const& entry : _entries) {
+		if (!match_pattern(entry.pattern.c_str(), method.c_str())) {
+			continue;
+		}
+
+		// Source filters only apply to notifications which reference a source.
+		if (entry.sources.empty() || sources.empty()) {
+			return true;
+		}
+		for (auto const& source : sources) {
+			if (entry.sources.count(source) > 0) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+const std::vector<streamdeck::jsonrpc::subscriptions::entry>& streamdeck::jsonrpc::subscriptions::entries() const
+{
+	return _entries;
+}
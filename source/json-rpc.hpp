@@ -29,15 +29,21 @@
 
 #pragma once // Replaces Preprocessor guards, works on most major compilers (MSVC, GCC, Clang, ...)
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include <set>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #define REMOTE_NOT_CONNECTED "[Not Connected]"
 
 namespace streamdeck {
+	class call_state;
+
 	namespace jsonrpc {
 		enum error_codes : int64_t {
 			PARSE_ERROR      = -32700,
@@ -48,6 +54,7 @@ namespace streamdeck {
 			SERVER_ERROR_MAX = -32099,
 			SERVER_ERROR     = -32000,
 			// Reserved error codes (-32099 - -32000)
+			REQUEST_TIMEOUT  = -32001, // The request's deadline passed before it was answered.
 		};
 
 		class error : public std::runtime_error {
@@ -134,13 +141,38 @@ namespace streamdeck {
 			}
 		};
 
+		class subscriptions {
+			public:
+			struct entry {
+				std::string           pattern; // Method name, may contain '*' as a wildcard.
+				std::set<std::string> sources; // Empty means any source.
+			};
+
+			private:
+			std::vector<entry> _entries;
+
+			public:
+			subscriptions& add(const std::string& pattern, const std::set<std::string>& sources);
+			subscriptions& remove(const std::string& pattern);
+			subscriptions& clear();
+
+			bool                      matches(const std::string& method, const std::vector<std::string>& sources) const;
+			const std::vector<entry>& entries() const;
+		};
+
 		class client {
-			std::string _remote_version;
+			std::string                          _remote_version;
+			std::shared_ptr<const subscriptions> _subscriptions;
 
 			public:
 			client();
 			void set_version(const std::string& version);
 			std::string get_version() const;
+
+			// Subscriptions may be read from any thread. A client which never subscribed receives everything.
+			void                                 set_subscriptions(std::shared_ptr<const subscriptions> value);
+			std::shared_ptr<const subscriptions> get_subscriptions() const;
+			bool is_subscribed(const std::string& method, const std::vector<std::string>& sources) const;
 		};
 
 		class jsonrpc {
@@ -148,8 +180,9 @@ namespace streamdeck {
 			virtual ~jsonrpc();
 			jsonrpc();
 
-			nlohmann::json _json;
-			client*        _client;
+			nlohmann::json                          _json;
+			client*                                 _client;
+			std::shared_ptr<streamdeck::call_state> _call;
 
 			public:
 			jsonrpc& clear_id();
@@ -162,17 +195,31 @@ namespace streamdeck {
 			jsonrpc& copy_id(streamdeck::jsonrpc::jsonrpc& other);
 			client*  get_client();
 
+			// The asynchronous call this belongs to, if any. Carried over by copy_id(), so that a reply knows which
+			// call it answers.
+			jsonrpc&                                       set_call(std::shared_ptr<streamdeck::call_state> value);
+			const std::shared_ptr<streamdeck::call_state>& get_call() const;
+
 			nlohmann::json compile();
 
+			// Like compile(), but moves the document out instead of copying it. Leaves this object empty.
+			nlohmann::json release();
+
 			public:
 			virtual void validate() = 0;
 		};
 
 		class request : public jsonrpc {
+			std::weak_ptr<void> _handle;
+
 			public:
 			virtual ~request();
 			request();
-			request(nlohmann::json& json, client* c);
+			request(nlohmann::json json, client* c); // Move the parsed document in to avoid copying it.
+
+			// Handle of the connection the request arrived on, the same asynchronous handlers are called with.
+			request&                   set_handle(std::weak_ptr<void> value);
+			const std::weak_ptr<void>& get_handle() const;
 
 			request&    set_method(const std::string& value);
 			bool        get_method(std::string& value);
@@ -182,6 +229,12 @@ namespace streamdeck {
 			request& set_params(nlohmann::json value);
 			bool     get_params(nlohmann::json& value);
 
+			// The params without copying them, or null if there are none. Valid until the request is modified.
+			const nlohmann::json& get_params() const;
+
+			// Optional deadline for answering the request, in milliseconds from receiving it. Capped at a day.
+			bool get_timeout(std::chrono::milliseconds& value);
+
 			public:
 			virtual void validate() override;
 		};
@@ -190,7 +243,7 @@ namespace streamdeck {
 			public:
 			virtual ~response();
 			response();
-			response(nlohmann::json& json, client* c);
+			response(nlohmann::json json, client* c);
 
 			response& set_result(nlohmann::json value);
 			bool      get_result(nlohmann::json& value);
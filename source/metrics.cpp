@@ -0,0 +1,152 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "metrics.hpp"
+
+static thread_local const streamdeck::metrics_scope* _current_scope = nullptr;
+
+size_t streamdeck::latency_histogram::bucket_of(uint64_t value)
+{
+	if (value > MAX_VALUE) {
+		value = MAX_VALUE;
+	}
+	if (value < SUB_COUNT) {
+		return static_cast<size_t>(value);
+	}
+
+	// The highest set bit selects the power of two, the SUB_BITS below it the bucket within.
+	size_t bits = 0;
+	while ((value >> bits) >= (SUB_COUNT * 2)) {
+		bits++;
+	}
+	return (bits + 1) * SUB_COUNT + static_cast<size_t>((value >> bits) - SUB_COUNT);
+}
+
+uint64_t streamdeck::latency_histogram::bucket_limit(size_t bucket)
+{
+	// Highest value that lands in the given bucket.
+	if (bucket < SUB_COUNT) {
+		return bucket;
+	}
+	size_t bits = bucket / SUB_COUNT - 1;
+	return ((static_cast<uint64_t>(SUB_COUNT + bucket % SUB_COUNT) + 1) << bits) - 1;
+}
+
+streamdeck::latency_histogram::latency_histogram() : _count(0), _sum(0), _max(0)
+{
+	for (auto& bucket : _buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+}
+
+void streamdeck::latency_histogram::record(uint64_t value)
+{
+	_buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(value, std::memory_order_relaxed);
+
+	uint64_t max = _max.load(std::memory_order_relaxed);
+	while ((value > max) && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+	}
+}
+
+void streamdeck::latency_histogram::record(std::chrono::steady_clock::duration duration)
+{
+	auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+	record(static_cast<uint64_t>(us > 0 ? us : 0));
+}
+
+uint64_t streamdeck::latency_histogram::count() const
+{
+	return _count.load(std::memory_order_relaxed);
+}
+
+nlohmann::json streamdeck::latency_histogram::to_json() const
+{
+	// Buckets are read one by one while others may still record, so the result is only approximately consistent.
+	uint64_t counts[BUCKETS];
+	uint64_t total = 0;
+	for (size_t idx = 0; idx < BUCKETS; idx++) {
+		counts[idx] = _buckets[idx].load(std::memory_order_relaxed);
+		total += counts[idx];
+	}
+
+	nlohmann::json result = nlohmann::json::object();
+	result["count"]       = total;
+	result["mean"]        = total > 0 ? static_cast<double>(_sum.load(std::memory_order_relaxed)) / total : 0.0;
+	result["max"]         = _max.load(std::memory_order_relaxed);
+
+	static const std::pair<const char*, double> percentiles[] = {
+		{"p50", 0.5}, {"p90", 0.9}, {"p99", 0.99}, {"p999", 0.999}};
+	for (auto const& percentile : percentiles) {
+		uint64_t rank  = static_cast<uint64_t>(percentile.second * total + 0.5);
+		uint64_t seen  = 0;
+		uint64_t value = 0;
+		for (size_t idx = 0; (idx < BUCKETS) && (total > 0); idx++) {
+			seen += counts[idx];
+			if ((seen >= rank) && (counts[idx] > 0)) {
+				value = bucket_limit(idx);
+				break;
+			}
+		}
+		result[percentile.first] = value;
+	}
+
+	return result;
+}
+
+nlohmann::json streamdeck::method_metrics::to_json() const
+{
+	nlohmann::json result = nlohmann::json::object();
+	result["calls"]       = calls.load(std::memory_order_relaxed);
+	result["errors"]      = errors.load(std::memory_order_relaxed);
+	result["timeouts"]    = timeouts.load(std::memory_order_relaxed);
+	result["cancelled"]   = cancelled.load(std::memory_order_relaxed);
+	result["shared"]      = shared.load(std::memory_order_relaxed);
+	result["dispatch"]    = dispatch.to_json();
+	if (queue.count() > 0) {
+		result["queue"]   = queue.to_json();
+		result["execute"] = execute.to_json();
+	}
+	result["total"] = total.to_json();
+	return result;
+}
+
+streamdeck::metrics_scope::~metrics_scope()
+{
+	_current_scope = _previous;
+}
+
+streamdeck::metrics_scope::metrics_scope(std::shared_ptr<method_metrics>       metrics,
+										 std::chrono::steady_clock::time_point received)
+	: _metrics(std::move(metrics)), _received(received), _previous(_current_scope)
+{
+	_current_scope = this;
+}
+
+const std::shared_ptr<streamdeck::method_metrics>& streamdeck::metrics_scope::metrics() const
+{
+	return _metrics;
+}
+
+std::chrono::steady_clock::time_point streamdeck::metrics_scope::received() const
+{
+	return _received;
+}
+
+const streamdeck::metrics_scope* streamdeck::metrics_scope::current()
+{
+	return _current_scope;
+}
@@ -0,0 +1,98 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <nlohmann/json.hpp>
+
+namespace streamdeck {
+	// Lock-free latency histogram with log-linear buckets, in the spirit of HdrHistogram.
+	//
+	// Values are recorded in microseconds. Every power of two is split into 8 buckets, so reported percentiles are
+	// within 12.5% of the actual value. Anything above ~134 seconds ends up in the last bucket.
+	class latency_histogram {
+		static constexpr size_t   SUB_BITS  = 3;
+		static constexpr size_t   SUB_COUNT = size_t(1) << SUB_BITS;
+		static constexpr size_t   MAX_BITS  = 27;
+		static constexpr size_t   BUCKETS   = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT;
+		static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_BITS) - 1;
+
+		std::atomic<uint64_t> _buckets[BUCKETS];
+		std::atomic<uint64_t> _count;
+		std::atomic<uint64_t> _sum;
+		std::atomic<uint64_t> _max;
+
+		static size_t   bucket_of(uint64_t value);
+		static uint64_t bucket_limit(size_t bucket);
+
+		public:
+		latency_histogram();
+
+		latency_histogram(const latency_histogram&) = delete;
+		latency_histogram& operator=(const latency_histogram&) = delete;
+
+		void record(uint64_t value);
+		void record(std::chrono::steady_clock::duration duration);
+
+		uint64_t count() const;
+
+		// Count, mean, max and the usual percentiles, all in microseconds.
+		nlohmann::json to_json() const;
+	};
+
+	struct method_metrics {
+		std::atomic<uint64_t> calls;
+		std::atomic<uint64_t> errors;
+		std::atomic<uint64_t> timeouts;  // Answered with a timeout error, as the deadline passed first.
+		std::atomic<uint64_t> cancelled; // Queued tasks skipped, as nobody waited for their reply anymore.
+		std::atomic<uint64_t> shared;    // Answered with the outcome of an identical call earlier in the batch.
+		latency_histogram     dispatch; // Time spent in the dispatcher, including synchronous handlers.
+		latency_histogram     queue;    // Time tasks queued by the handler waited for their OBS thread.
+		latency_histogram     execute;  // Run time of those tasks.
+		latency_histogram     total;    // From receiving the message until the reply was queued.
+
+		method_metrics()
+			: calls(0), errors(0), timeouts(0), cancelled(0), shared(0), dispatch(), queue(), execute(), total()
+		{}
+
+		nlohmann::json to_json() const;
+	};
+
+	// Marks the method a thread is currently working on, so that tasks queued and replies sent from inside a handler
+	// are attributed to it. Scopes nest, the previous one is restored on destruction.
+	class metrics_scope {
+		std::shared_ptr<method_metrics>       _metrics;
+		std::chrono::steady_clock::time_point _received;
+		const metrics_scope*                  _previous;
+
+		public:
+		~metrics_scope();
+		metrics_scope(std::shared_ptr<method_metrics> metrics, std::chrono::steady_clock::time_point received);
+
+		metrics_scope(const metrics_scope&) = delete;
+		metrics_scope& operator=(const metrics_scope&) = delete;
+
+		const std::shared_ptr<method_metrics>& metrics() const;
+		std::chrono::steady_clock::time_point  received() const;
+
+		// The innermost scope on this thread, or nullptr.
+		static const metrics_scope* current();
+	};
+} // namespace streamdeck
@@ -17,6 +17,8 @@
 #include <cstdarg>
 #include <vector>
 #include <memory>
+#include "call-state.hpp"
+#include "metrics.hpp"
 #include "server.hpp"
 #include "version.hpp"
 #include "details-popup.hpp"
@@ -49,6 +51,9 @@ MODULE_EXPORT bool obs_module_load(void)
 		_handler_obs_frontend = streamdeck::handlers::obs_frontend::instance();
 		_handler_obs_scene    = streamdeck::handlers::obs_scene::instance();
 		_handler_obs_source   = streamdeck::handlers::obs_source::instance();
+
+		// All handlers are registered, start serving.
+		_server->start();
 		return true;
 	} catch (...) {
 		// If an exception occured, immediately abort everything.
@@ -90,6 +95,40 @@ void streamdeck::message(streamdeck::log_level level, const char* format, ...)
 
 
 void streamdeck::queue_task(obs_task_type type, bool wait, std::function<void()> func) {
+	// Tasks queued while handling a request count towards that request's method.
+	if (auto scope = streamdeck::metrics_scope::current(); scope && scope->metrics()) {
+		auto metrics  = scope->metrics();
+		auto received = scope->received();
+		auto queued   = std::chrono::steady_clock::now();
+		auto task     = std::move(func);
+		func = [task, metrics, received, queued]() {
+			auto                      started = std::chrono::steady_clock::now();
+			streamdeck::metrics_scope scope(metrics, received);
+			metrics->queue.record(started - queued);
+			task();
+			metrics->execute.record(std::chrono::steady_clock::now() - started);
+		};
+	}
+
+	// Tasks queued for an asynchronous call are skipped once nobody waits for its reply anymore. Otherwise they run
+	// inside the call's scope, so that a reply arriving after the deadline can be told apart.
+	if (auto scope = streamdeck::call_scope::current(); scope && scope->state()) {
+		auto method  = streamdeck::metrics_scope::current();
+		auto metrics = method ? method->metrics() : nullptr;
+		auto state   = scope->state();
+		auto task    = std::move(func);
+		func = [task, metrics, state]() {
+			if (state->cancelled()) {
+				if (metrics) {
+					metrics->cancelled++;
+				}
+				return;
+			}
+			streamdeck::call_scope scope(state);
+			task();
+		};
+	}
+
 	std::function<void()>* pd = new std::function<void()>(std::move(func));
 
 	obs_queue_task(
@@ -34,5 +34,6 @@ namespace streamdeck {
 
 	void message(log_level level, const char* format, ...);
 
+	// Like obs_queue_task(), which also records the wait and run time for the method being handled.
 	void queue_task(obs_task_type type, bool wait, std::function<void()> func);
 } // namespace streamdeck
@@ -0,0 +1,78 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <atomic>
+#include <utility>
+
+namespace streamdeck {
+	// Unbounded multi-producer single-consumer queue (Vyukov style).
+	//
+	// push() may be called from any thread and never blocks. pop() must only ever be called from a single thread at a
+	// time. A pop() that races with an unfinished push() may report the queue as empty, so producers are expected to
+	// wake the consumer after pushing.
+	template<typename T>
+	class mpsc_queue {
+		struct node {
+			std::atomic<node*> next;
+			T                  value;
+
+			node() : next(nullptr), value() {}
+			node(T&& v) : next(nullptr), value(std::move(v)) {}
+		};
+
+		std::atomic<node*> _head; // Producers append here.
+		node*              _tail; // Consumer removes here, always points at an already consumed node.
+
+		public:
+		~mpsc_queue()
+		{
+			T value;
+			while (pop(value)) {
+			}
+			delete _tail;
+		}
+
+		mpsc_queue() : _head(nullptr), _tail(nullptr)
+		{
+			_tail = new node();
+			_head.store(_tail, std::memory_order_relaxed);
+		}
+
+		mpsc_queue(const mpsc_queue&) = delete;
+		mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+		void push(T&& value)
+		{
+			node* entry = new node(std::move(value));
+			node* prev  = _head.exchange(entry, std::memory_order_acq_rel);
+			prev->next.store(entry, std::memory_order_release);
+		}
+
+		bool pop(T& value)
+		{
+			node* tail = _tail;
+			node* next = tail->next.load(std::memory_order_acquire);
+			if (!next) {
+				return false;
+			}
+
+			value = std::move(next->value);
+			_tail = next;
+			delete tail;
+			return true;
+		}
+	};
+} // namespace streamdeck
@@ -0,0 +1,129 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "param-schema.hpp"
+#include <cstdio>
+
+static const struct {
+	uint32_t    type;
+	const char* prose; // As used in error messages.
+	const char* title; // As used in the documentation.
+	const char* key;   // As used in JSON descriptions.
+} type_table[] = {
+	{streamdeck::params::BOOLEAN, "a Boolean", "Boolean", "boolean"},
+	{streamdeck::params::INTEGER, "an integer", "Integer", "integer"},
+	{streamdeck::params::NUMBER, "a number", "Number", "number"},
+	{streamdeck::params::STRING, "a string", "String", "string"},
+	{streamdeck::params::ARRAY, "an array", "Array", "array"},
+	{streamdeck::params::OBJECT, "an object", "Object", "object"},
+	{streamdeck::params::NUL, "null", "Null", "null"},
+};
+
+static std::string format_number(double value)
+{
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%g", value);
+	return buffer;
+}
+
+std::string streamdeck::params::type_names(uint32_t types)
+{
+	std::vector<const char*> names;
+	for (auto const& entry : type_table) {
+		if (types & entry.type) {
+			names.push_back(entry.prose);
+		}
+	}
+
+	std::string result;
+	for (size_t idx = 0; idx < names.size(); idx++) {
+		if (idx > 0) {
+			result += (idx + 1 == names.size()) ? " or " : ", ";
+		}
+		result += names[idx];
+	}
+	return result;
+}
+
+nlohmann::json streamdeck::params::to_json(const std::vector<info>& infos)
+{
+	nlohmann::json result = nlohmann::json::array();
+	for (auto const& param : infos) {
+		nlohmann::json types = nlohmann::json::array();
+		for (auto const& entry : type_table) {
+			if (param.types & entry.type) {
+				types.push_back(entry.key);
+			}
+		}
+
+		nlohmann::json o = nlohmann::json::object();
+		o["name"]        = param.name;
+		o["types"]       = std::move(types);
+		o["required"]    = param.required;
+		o["description"] = param.description;
+		if (param.minimum != std::numeric_limits<double>::lowest()) {
+			o["minimum"] = param.minimum;
+		}
+		if (param.maximum != std::numeric_limits<double>::max()) {
+			o["maximum"] = param.maximum;
+		}
+		result.push_back(std::move(o));
+	}
+	return result;
+}
+
+std::string streamdeck::params::to_markdown(const std::vector<info>& infos)
+{
+	std::string result = "##### Parameters\nAn object containing:\n\n";
+	for (auto const& param : infos) {
+		std::string types;
+		for (auto const& entry : type_table) {
+			if (param.types & entry.type) {
+				types += types.empty() ? "" : "|";
+				types += entry.title;
+			}
+		}
+
+		result += "- <small>" + types + "</small> `" + param.name + "`";
+		if (!param.required) {
+			result += " *(Optional)*";
+		}
+		result += "\n  " + param.description;
+		bool bounded_below = param.minimum != std::numeric_limits<double>::lowest();
+		bool bounded_above = param.maximum != std::numeric_limits<double>::max();
+		if (bounded_below && bounded_above) {
+			result += " From " + format_number(param.minimum) + " to " + format_number(param.maximum) + ".";
+		} else if (bounded_below) {
+			result += " At least " + format_number(param.minimum) + ".";
+		} else if (bounded_above) {
+			result += " At most " + format_number(param.maximum) + ".";
+		}
+		result += "\n";
+	}
+	return result;
+}
+
+void streamdeck::params::throw_out_of_range(const char* name, double minimum, double maximum)
+{
+	std::string message = std::string("'") + name + "'";
+	if (minimum == std::numeric_limits<double>::lowest()) {
+		message += " can't be higher than " + format_number(maximum) + ".";
+	} else if (maximum == std::numeric_limits<double>::max()) {
+		message += " can't be lower than " + format_number(minimum) + ".";
+	} else {
+		message += " can't be lower than " + format_number(minimum) + " or higher than " + format_number(maximum) + ".";
+	}
+	throw streamdeck::jsonrpc::invalid_params_error(message.c_str());
+}
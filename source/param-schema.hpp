@@ -0,0 +1,323 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "json-rpc.hpp"
+
+namespace streamdeck {
+	namespace params {
+		// JSON types a parameter accepts, combined with '|'.
+		enum type : uint32_t {
+			BOOLEAN = 1 << 0,
+			INTEGER = 1 << 1,
+			NUMBER  = 1 << 2, // Includes integers.
+			STRING  = 1 << 3,
+			ARRAY   = 1 << 4,
+			OBJECT  = 1 << 5,
+			NUL     = 1 << 6,
+		};
+
+		// Description of a parameter, kept by the server after registration.
+		struct info {
+			std::string name;
+			uint32_t    types;
+			bool        required;
+			double      minimum; // Inclusive bounds for numbers.
+			double      maximum;
+			std::string description;
+		};
+
+		// Human readable list of types, such as "a number or an object".
+		std::string type_names(uint32_t types);
+
+		// The parameters as JSON, and as a list in the style of docs/rpc-definition.md.
+		nlohmann::json to_json(const std::vector<info>& infos);
+		std::string    to_markdown(const std::vector<info>& infos);
+
+		// Throws the invalid params error for a parameter with a value outside of its bounds.
+		[[noreturn]] void throw_out_of_range(const char* name, double minimum, double maximum);
+
+		// A parameter decoded into a member of T. Booleans, numbers and strings are decoded into std::optional
+		// members, anything else (or a mix of types) is borrowed from the request as a pointer, null if absent.
+		template<typename T>
+		struct field {
+			const char*                     name;
+			uint32_t                        types;
+			bool                            required;
+			double                          minimum;
+			double                          maximum;
+			const char*                     description;
+			std::optional<bool> T::*        as_boolean;
+			std::optional<int64_t> T::*     as_integer;
+			std::optional<double> T::*      as_number;
+			std::optional<std::string> T::* as_string;
+			const nlohmann::json* T::*      as_value;
+
+			constexpr field(const char* name, uint32_t types, const char* description)
+				: name(name), types(types), required(false), minimum(std::numeric_limits<double>::lowest()),
+				  maximum(std::numeric_limits<double>::max()), description(description), as_boolean(nullptr),
+				  as_integer(nullptr), as_number(nullptr), as_string(nullptr), as_value(nullptr)
+			{}
+
+			constexpr field require() const
+			{
+				field copy    = *this;
+				copy.required = true;
+				return copy;
+			}
+
+			constexpr field range(double low, double high) const
+			{
+				field copy   = *this;
+				copy.minimum = low;
+				copy.maximum = high;
+				return copy;
+			}
+		};
+
+		template<typename T>
+		constexpr field<T> boolean(const char* name, std::optional<bool> T::*member, const char* description)
+		{
+			field<T> result(name, BOOLEAN, description);
+			result.as_boolean = member;
+			return result;
+		}
+
+		template<typename T>
+		constexpr field<T> integer(const char* name, std::optional<int64_t> T::*member, const char* description)
+		{
+			field<T> result(name, INTEGER, description);
+			result.as_integer = member;
+			return result;
+		}
+
+		template<typename T>
+		constexpr field<T> number(const char* name, std::optional<double> T::*member, const char* description)
+		{
+			field<T> result(name, NUMBER, description);
+			result.as_number = member;
+			return result;
+		}
+
+		template<typename T>
+		constexpr field<T> string(const char* name, std::optional<std::string> T::*member, const char* description)
+		{
+			field<T> result(name, STRING, description);
+			result.as_string = member;
+			return result;
+		}
+
+		template<typename T>
+		constexpr field<T> value(const char* name, uint32_t types, const nlohmann::json* T::*member,
+								 const char* description)
+		{
+			field<T> result(name, types, description);
+			result.as_value = member;
+			return result;
+		}
+
+		// The parameters of a method, declared as a static constexpr array of fields.
+		//
+		// decode() checks and decodes the params of a request in a single pass over them, before anything is done
+		// with any of them. Members which aren't described are ignored. At most 64 fields are supported.
+		template<typename T>
+		class schema {
+			const field<T>* _fields;
+			size_t          _count;
+
+			static bool matches(uint32_t types, const nlohmann::json& value)
+			{
+				switch (value.type()) {
+				case nlohmann::json::value_t::boolean:
+					return types & BOOLEAN;
+				case nlohmann::json::value_t::number_integer:
+				case nlohmann::json::value_t::number_unsigned:
+					return types & (INTEGER | NUMBER);
+				case nlohmann::json::value_t::number_float:
+					return types & NUMBER;
+				case nlohmann::json::value_t::string:
+					return types & STRING;
+				case nlohmann::json::value_t::array:
+					return types & ARRAY;
+				case nlohmann::json::value_t::object:
+					return types & OBJECT;
+				case nlohmann::json::value_t::null:
+					return types & NUL;
+				default:
+					return false;
+				}
+			}
+
+			public:
+			typedef std::function<void(const T&, std::shared_ptr<streamdeck::jsonrpc::request>,
+									   std::shared_ptr<streamdeck::jsonrpc::response>)>
+				callback_t;
+			typedef std::function<void(const T&, std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>)>
+				async_callback_t;
+
+			template<size_t N>
+			constexpr schema(const field<T> (&fields)[N]) : _fields(fields), _count(N)
+			{
+				static_assert(N <= 64, "Too many fields for a parameter schema.");
+			}
+
+			T decode(const nlohmann::json& params) const
+			{
+				T        decoded{};
+				uint64_t seen = 0;
+
+				if (params.is_object()) {
+					for (auto kv = params.begin(); kv != params.end(); ++kv) {
+						size_t idx = 0;
+						while ((idx < _count) && (kv.key() != _fields[idx].name)) {
+							idx++;
+						}
+						if (idx == _count) {
+							continue;
+						}
+
+						auto const& desc  = _fields[idx];
+						auto const& value = kv.value();
+						if (!matches(desc.types, value)) {
+							std::string message = std::string("'") + desc.name + "' must be " + type_names(desc.types)
+												  + ".";
+							throw streamdeck::jsonrpc::invalid_params_error(message.c_str());
+						}
+						if (value.is_number()) {
+							double number = value.get<double>();
+							if ((number < desc.minimum) || (number > desc.maximum)) {
+								throw_out_of_range(desc.name, desc.minimum, desc.maximum);
+							}
+						}
+
+						if (desc.as_boolean) {
+							decoded.*desc.as_boolean = value.get<bool>();
+						} else if (desc.as_integer) {
+							// Beyond the signed range, the value would wrap around.
+							if (value.is_number_unsigned()
+								&& (value.get<uint64_t>() > uint64_t(std::numeric_limits<int64_t>::max()))) {
+								throw_out_of_range(desc.name, desc.minimum,
+												   double(std::numeric_limits<int64_t>::max()));
+							}
+							decoded.*desc.as_integer = value.get<int64_t>();
+						} else if (desc.as_number) {
+							decoded.*desc.as_number = value.get<double>();
+						} else if (desc.as_string) {
+							decoded.*desc.as_string = value.get_ref<const std::string&>();
+						} else if (desc.as_value) {
+							decoded.*desc.as_value = &value;
+						}
+						seen |= uint64_t(1) << idx;
+					}
+				} else if (!params.is_null()) {
+					throw streamdeck::jsonrpc::invalid_params_error("Parameters must be an object.");
+				}
+
+				for (size_t idx = 0; idx < _count; idx++) {
+					if (_fields[idx].required && !(seen & (uint64_t(1) << idx))) {
+						if (params.is_null()) {
+							throw streamdeck::jsonrpc::invalid_params_error("Method requires parameters.");
+						}
+						std::string message = std::string("'") + _fields[idx].name + "' must be present.";
+						throw streamdeck::jsonrpc::invalid_params_error(message.c_str());
+					}
+				}
+				return decoded;
+			}
+
+			std::vector<info> describe() const
+			{
+				std::vector<info> infos;
+				infos.reserve(_count);
+				for (size_t idx = 0; idx < _count; idx++) {
+					auto const& desc = _fields[idx];
+					infos.push_back({desc.name, desc.types, desc.required, desc.minimum, desc.maximum,
+									 desc.description ? desc.description : ""});
+				}
+				return infos;
+			}
+
+			// Wrap a handler taking the decoded params into a regular synchronous handler.
+			std::function<void(std::shared_ptr<streamdeck::jsonrpc::request>,
+							   std::shared_ptr<streamdeck::jsonrpc::response>)>
+				bind(callback_t callback) const
+			{
+				return [self = *this, callback = std::move(callback)](
+						   std::shared_ptr<streamdeck::jsonrpc::request>  req,
+						   std::shared_ptr<streamdeck::jsonrpc::response> res) {
+					// Borrows from the params of req, which the handler holds on to for as long as it needs them.
+					T decoded = self.decode(req->get_params());
+					callback(decoded, std::move(req), std::move(res));
+				};
+			}
+
+			// Same for an asynchronous handler. Invalid params are replied to right away, before anything is queued.
+			std::function<void(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>)>
+				bind_async(async_callback_t callback) const
+			{
+				return [self = *this, callback = std::move(callback)](
+						   std::weak_ptr<void> handle, std::shared_ptr<streamdeck::jsonrpc::request> req) {
+					T decoded = self.decode(req->get_params());
+					callback(decoded, std::move(handle), std::move(req));
+				};
+			}
+		};
+
+		// Every method declared through params::method, with its params, in the order they were declared in.
+		inline std::vector<std::pair<std::string, std::vector<info>>>& declared_methods()
+		{
+			static std::vector<std::pair<std::string, std::vector<info>>> methods;
+			return methods;
+		}
+
+		// The name of a method together with its params, declared once as an inline variable next to the fields.
+		// Handlers are registered through it, and declaring it adds it to declared_methods(), so the list the docs are
+		// generated from can't miss a method that was registered with params.
+		template<typename T>
+		class method {
+			const char* _name;
+			schema<T>   _schema;
+
+			public:
+			template<size_t N>
+			method(const char* name, const field<T> (&fields)[N]) : _name(name), _schema(fields)
+			{
+				declared_methods().emplace_back(_name, _schema.describe());
+			}
+
+			const char* get_name() const
+			{
+				return _name;
+			}
+
+			const schema<T>& get_schema() const
+			{
+				return _schema;
+			}
+		};
+
+		template<typename T, size_t N>
+		method(const char*, const field<T> (&)[N]) -> method<T>;
+	} // namespace params
+} // namespace streamdeck
@@ -14,244 +14,1775 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "server.hpp"
+#include <algorithm>
 #include <cinttypes>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <random>
 #include "json-rpc.hpp"
 #include "module.hpp"
 #include "obs-frontend-api.h"
+#include "obs-module.h"
 
+#include <util/config-file.h>
+#include <util/platform.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 const unsigned short WEBSOCKET_PORTS[] = {28186, 39726, 34247, 42206, 38535, 40829, 40624, 0};
 #define WEBSOCKET_PROTOCOL "streamdeck-obs"
+#define WEBSOCKET_PROTOCOL_MSGPACK WEBSOCKET_PROTOCOL "+msgpack"
+#define WEBSOCKET_PROTOCOL_CBOR WEBSOCKET_PROTOCOL "+cbor"
+#define DISCOVERY_DIRECTORY "discovery"
+#define SHUTDOWN_TIMEOUT_MS 500
+#define BACKLOG_RETRY_MS 50
+#define BATCH_POOL_THREADS_MAX 4
+#define LOCAL_MESSAGE_SIZE_MAX 32000000
+#define WATCH_LIMIT 256
+
+#define CONFIG_SECTION "StreamDeck"
+#define CONFIG_COALESCE_INTERVAL "CoalesceInterval"
+#define CONFIG_DEFLATE_THRESHOLD "DeflateThreshold"
+#define CONFIG_SEND_BUFFER_LIMIT "SendBufferLimit"
+#define CONFIG_SEND_QUEUE_LIMIT "SendQueueLimit"
+#define CONFIG_LOCAL_SOCKET "LocalSocket"
+#define CONFIG_EVENT_RING_SIZE "EventRingSize"
+#define CONFIG_RESUME_HISTORY "ResumeHistory"
+#define CONFIG_RESUME_WINDOW "ResumeWindow"
+#define CONFIG_KEEPALIVE_INTERVAL "KeepaliveInterval"
+#define CONFIG_KEEPALIVE_TIMEOUT "KeepaliveTimeout"
+#define DEFAULT_COALESCE_INTERVAL_MS 20
+#define DEFAULT_DEFLATE_THRESHOLD 4096
+#define DEFAULT_SEND_BUFFER_LIMIT 1048576
+#define DEFAULT_SEND_QUEUE_LIMIT 256
+#define DEFAULT_LOCAL_SOCKET true
+#define DEFAULT_EVENT_RING_SIZE 0
+#define DEFAULT_RESUME_HISTORY 1024
+#define DEFAULT_RESUME_WINDOW_MS 60000
+#define DEFAULT_KEEPALIVE_INTERVAL_MS 15000
+#define DEFAULT_KEEPALIVE_TIMEOUT_MS 10000
+
+/* clang-format off */
+#define DLOG(LEVEL, ...) streamdeck::message(streamdeck::log_level:: LEVEL, "[Server] " __VA_ARGS__)
+/* clang-format on */
+
+static unsigned long process_id()
+{
+#ifdef _WIN32
+	return GetCurrentProcessId();
+#else
+	return static_cast<unsigned long>(getpid());
+#endif
+}
+
+static std::vector<std::string> referenced_sources(const nlohmann::json& params)
+{
+	// Collect the names of sources and scenes that notification or request parameters refer to.
+	std::vector<std::string> sources;
+	if (!params.is_object()) {
+		return sources;
+	}
+
+	auto p = params.find("source");
+	if (p != params.end()) {
+		if (p->is_string()) {
+			sources.push_back(p->get<std::string>());
+		} else if (p->is_array() && !p->empty() && p->at(0).is_string()) {
+			sources.push_back(p->at(0).get<std::string>());
+		}
+	}
+
+	p = params.find("scene");
+	if ((p != params.end()) && p->is_string()) {
+		sources.push_back(p->get<std::string>());
+	}
+
+	p = params.find("item"); // [Scene, Source, Id]
+	if ((p != params.end()) && p->is_array()) {
+		for (size_t idx = 0; (idx < 2) && (idx < p->size()); idx++) {
+			if (p->at(idx).is_string()) {
+				sources.push_back(p->at(idx).get<std::string>());
+			}
+		}
+	}
+
+	return sources;
+}
+
+static bool same_connection(const std::weak_ptr<void>& left, const std::weak_ptr<void>& right)
+{
+	return !left.owner_before(right) && !right.owner_before(left);
+}
+
+static std::shared_ptr<streamdeck::jsonrpc::response>
+	error_response(const std::shared_ptr<streamdeck::jsonrpc::request>& req, int64_t code, const char* message)
+{
+	auto res = std::make_shared<streamdeck::jsonrpc::response>();
+	if (req) {
+		// Missing if the request itself failed validation.
+		res->copy_id(*req);
+	}
+	res->set_error(code, message ? message : "Unknown error.");
+	return res;
+}
+
+static std::vector<std::vector<size_t>> batch_groups(const nlohmann::json& input)
+{
+	// Entries referring to the same source, scene or scene item must run in order, so they end up in the same group.
+	// Entries without such a reference may touch global state, so they all share one group as well.
+	std::vector<size_t>           parent(input.size());
+	std::map<std::string, size_t> owners;
+
+	auto find = [&parent](size_t idx) {
+		while (parent[idx] != idx) {
+			parent[idx] = parent[parent[idx]];
+			idx         = parent[idx];
+		}
+		return idx;
+	};
+
+	for (size_t idx = 0; idx < input.size(); idx++) {
+		parent[idx] = idx;
+
+		std::vector<std::string> keys;
+		auto const&              entry = input.at(idx);
+		if (entry.is_object()) {
+			auto p = entry.find("params");
+			if (p != entry.end()) {
+				keys = referenced_sources(*p);
+			}
+		}
+		if (keys.empty()) {
+			keys.emplace_back(); // Source names are never empty, so this stands for global state.
+		}
+
+		for (auto const& key : keys) {
+			auto iter = owners.find(key);
+			if (iter == owners.end()) {
+				owners.emplace(key, idx);
+			} else {
+				parent[find(idx)] = find(iter->second);
+			}
+		}
+	}
+
+	std::map<size_t, std::vector<size_t>> roots;
+	for (size_t idx = 0; idx < input.size(); idx++) {
+		roots[find(idx)].push_back(idx);
+	}
+
+	std::vector<std::vector<size_t>> groups;
+	groups.reserve(roots.size());
+	for (auto& kv : roots) {
+		groups.push_back(std::move(kv.second));
+	}
+	return groups;
+}
+
+streamdeck::server::~server()
+{
+	DLOG(LOG_DEBUG, "Destroying WebSocket handler...");
+
+	obs_remove_tick_callback(&streamdeck::server::on_video_tick, this);
+
+	// Worker: Signal to stop, and let the io_context shut down the WebSocket side.
+	_worker_alive = false;
+	asio::post(_ws.get_io_service(), std::bind(&streamdeck::server::shutdown, this));
+
+	// Worker: Join.
+	if (_worker.joinable())
+		_worker.join();
+
+	// Batches: Let running groups finish, as they refer to us.
+	_batch_pool->join();
+
+	auto stats = get_coalesce_stats();
+	DLOG(LOG_INFO,
+		 "Coalesced notifications: %" PRIu64 " received, %" PRIu64 " merged, %" PRIu64 " dropped, %" PRIu64 " sent.",
+		 stats.received, stats.merged, stats.dropped, stats.sent);
+
+	auto deflate = get_deflate_stats();
+	if (deflate.messages > 0) {
+		DLOG(LOG_INFO, "Compressed %" PRIu64 " frames to %.1f%% of their size, taking %.1f us per frame on average.",
+			 deflate.messages, deflate.bytes_out * 100.0 / deflate.bytes_in,
+			 deflate.time_ns / 1000.0 / deflate.messages);
+	}
+
+	auto backlog = get_backlog_stats();
+	if (backlog.deferred > 0) {
+		DLOG(LOG_INFO, "Held back %" PRIu64 " frames for slow clients, %" PRIu64 " merged, %" PRIu64 " dropped.",
+			 backlog.deferred, backlog.merged, backlog.dropped);
+	}
+}
+
+streamdeck::server::server()
+	: _ws(), _ws_clients(), _ws_clients_lock(), _clients_snapshot(std::make_shared<client_list_t>()), _outbound(),
+	  _outbound_pending(false), _outbound_strand(), _frame_manager(std::make_shared<ws_msg_manager_t>()), _frame_rng(),
+	  _frame_processor(), _deflate_threshold(DEFAULT_DEFLATE_THRESHOLD), _deflate_messages(0), _deflate_bytes_in(0),
+	  _deflate_bytes_out(0), _deflate_time_ns(0), _backlog_bytes(DEFAULT_SEND_BUFFER_LIMIT),
+	  _backlog_messages(DEFAULT_SEND_QUEUE_LIMIT), _backlog_scheduled(false), _backlog_deferred(0), _backlog_merged(0),
+	  _backlog_dropped(0), _coalesce_lock(), _coalesced(), _coalesced_pending(0),
+	  _coalesce_scheduled(false), _coalesce_interval(DEFAULT_COALESCE_INTERVAL_MS), _coalesce_received(0),
+	  _coalesce_merged(0), _coalesce_dropped(0), _coalesce_sent(0), _payloads_built(0),
+	  _payloads_skipped(0), _payloads_discarded(0), _batch_pool(), _batch_slots_lock(), _batch_slots(),
+	  _batch_slots_active(0), _watch_triggers(), _watches_lock(), _watches(), _watched(), _watch_next(0),
+	  _watches_active(0), _watch_evaluations(0), _watch_changes(0), _parse_latency(), _messages_received(0),
+	  _bytes_received(0), _messages_sent(0), _bytes_sent(0), _invalid_calls(0), _late_replies(0),
+	  _session(), _sequence(0), _history_lock(), _history(), _history_limit(DEFAULT_RESUME_HISTORY), _history_start(1),
+	  _history_gap(false), _history_pruned(0), _detach_window(DEFAULT_RESUME_WINDOW_MS), _detached(),
+	  _keepalive_interval(DEFAULT_KEEPALIVE_INTERVAL_MS), _keepalive_timeout(DEFAULT_KEEPALIVE_TIMEOUT_MS),
+	  _keepalive_pings(0), _keepalive_reaped(0),
+#ifdef HAVE_LOCAL_TRANSPORT
+	  _local_enabled(DEFAULT_LOCAL_SOCKET), _local_acceptor(), _local_sessions(), _local_path(),
+#endif
+#ifdef HAVE_EVENT_RING
+	  _event_ring_size(DEFAULT_EVENT_RING_SIZE), _event_ring(),
+#endif
+
+	  _worker(), _worker_alive(true)
+{
+	DLOG(LOG_DEBUG, "Creating WebSocket handler...");
+
+	// Coalescing: Allow tuning the window through the global configuration.
+	config_t* config = obs_frontend_get_global_config();
+	if (config) {
+		config_set_default_int(config, CONFIG_SECTION, CONFIG_COALESCE_INTERVAL, DEFAULT_COALESCE_INTERVAL_MS);
+		config_set_default_uint(config, CONFIG_SECTION, CONFIG_DEFLATE_THRESHOLD, DEFAULT_DEFLATE_THRESHOLD);
+		config_set_default_uint(config, CONFIG_SECTION, CONFIG_SEND_BUFFER_LIMIT, DEFAULT_SEND_BUFFER_LIMIT);
+		config_set_default_uint(config, CONFIG_SECTION, CONFIG_SEND_QUEUE_LIMIT, DEFAULT_SEND_QUEUE_LIMIT);
+		set_coalesce_interval(
+			std::chrono::milliseconds(config_get_int(config, CONFIG_SECTION, CONFIG_COALESCE_INTERVAL)));
+		_deflate_threshold = static_cast<size_t>(config_get_uint(config, CONFIG_SECTION, CONFIG_DEFLATE_THRESHOLD));
+		_backlog_bytes     = static_cast<size_t>(config_get_uint(config, CONFIG_SECTION, CONFIG_SEND_BUFFER_LIMIT));
+		_backlog_messages  = static_cast<size_t>(config_get_uint(config, CONFIG_SECTION, CONFIG_SEND_QUEUE_LIMIT));
+#ifdef HAVE_LOCAL_TRANSPORT
+		config_set_default_bool(config, CONFIG_SECTION, CONFIG_LOCAL_SOCKET, DEFAULT_LOCAL_SOCKET);
+		_local_enabled = config_get_bool(config, CONFIG_SECTION, CONFIG_LOCAL_SOCKET);
+#endif
+		config_set_default_uint(config, CONFIG_SECTION, CONFIG_RESUME_HISTORY, DEFAULT_RESUME_HISTORY);
+		config_set_default_int(config, CONFIG_SECTION, CONFIG_RESUME_WINDOW, DEFAULT_RESUME_WINDOW_MS);
+		_history_limit = static_cast<size_t>(config_get_uint(config, CONFIG_SECTION, CONFIG_RESUME_HISTORY));
+		_detach_window = std::chrono::milliseconds(config_get_int(config, CONFIG_SECTION, CONFIG_RESUME_WINDOW));
+		config_set_default_int(config, CONFIG_SECTION, CONFIG_KEEPALIVE_INTERVAL, DEFAULT_KEEPALIVE_INTERVAL_MS);
+		config_set_default_int(config, CONFIG_SECTION, CONFIG_KEEPALIVE_TIMEOUT, DEFAULT_KEEPALIVE_TIMEOUT_MS);
+		_keepalive_interval =
+			std::chrono::milliseconds(config_get_int(config, CONFIG_SECTION, CONFIG_KEEPALIVE_INTERVAL));
+		_keepalive_timeout =
+			std::chrono::milliseconds(config_get_int(config, CONFIG_SECTION, CONFIG_KEEPALIVE_TIMEOUT));
+#ifdef HAVE_EVENT_RING
+		config_set_default_uint(config, CONFIG_SECTION, CONFIG_EVENT_RING_SIZE, DEFAULT_EVENT_RING_SIZE);
+		_event_ring_size = static_cast<size_t>(config_get_uint(config, CONFIG_SECTION, CONFIG_EVENT_RING_SIZE));
+#endif
+	}
+
+	{ // Sessions: Tell this instance apart from earlier ones, whose sequence numbers mean nothing here.
+		std::random_device rd;
+		char               buffer[17];
+		snprintf(buffer, sizeof(buffer), "%08" PRIx32 "%08" PRIx32, uint32_t(rd()), uint32_t(rd()));
+		_session = buffer;
+	}
+
+	// Batches: Spin up the pool.
+	_batch_pool = std::make_unique<asio::thread_pool>(
+		std::max<unsigned>(2, std::min<unsigned>(BATCH_POOL_THREADS_MAX, std::thread::hardware_concurrency())));
+
+	// WebSocket: Initialize.
+	_ws.set_access_channels(websocketpp::log::alevel::all ^ websocketpp::log::alevel::frame_payload);
+	_ws.set_error_channels(websocketpp::log::elevel::all);
+	_ws.set_listen_backlog(1);
+	_ws.init_asio();
+	_outbound_strand = std::make_unique<asio::io_service::strand>(_ws.get_io_service());
+	_frame_processor = std::make_unique<ws_processor_t>(false, true, _frame_manager, _frame_rng);
+#ifdef ENABLE_PERMESSAGE_DEFLATE
+	{ // Compress without context takeover, so that the same compressed frame is valid on every deflate connection.
+		ws_config::request_type request;
+		request.replace_header("Sec-WebSocket-Extensions", "permessage-deflate; server_no_context_takeover");
+		_frame_processor->negotiate_extensions(request);
+	}
+#endif
+
+	// WebSocket: Set callbacks.
+	_ws.set_validate_handler(std::bind(&streamdeck::server::ws_on_validate, this, std::placeholders::_1));
+	_ws.set_open_handler(std::bind(&streamdeck::server::ws_on_open, this, std::placeholders::_1));
+	_ws.set_message_handler(
+		std::bind(&streamdeck::server::ws_on_message, this, std::placeholders::_1, std::placeholders::_2));
+	_ws.set_close_handler(std::bind(&streamdeck::server::ws_on_close, this, std::placeholders::_1));
+	_ws.set_pong_handler(
+		std::bind(&streamdeck::server::ws_on_pong, this, std::placeholders::_1, std::placeholders::_2));
+	_ws.set_pong_timeout_handler(
+		std::bind(&streamdeck::server::ws_on_pong_timeout, this, std::placeholders::_1, std::placeholders::_2));
+
+	// A new ping restarts the pong timer of its connection, so the timeout must not outlast the interval.
+	if (_keepalive_interval.count() > 0) {
+		_keepalive_timeout = std::max(std::min(_keepalive_timeout, _keepalive_interval), std::chrono::milliseconds(1));
+		_ws.set_pong_timeout(static_cast<long>(_keepalive_timeout.count()));
+	}
+
+	obs_add_tick_callback(&streamdeck::server::on_video_tick, this);
+}
+
+void streamdeck::server::start()
+{
+	if (_worker.joinable()) {
+		return;
+	}
+
+	// Registration is over. From here on the handlers are only read, from any thread and without locking.
+	_handlers.freeze();
+	DLOG(LOG_DEBUG, "Registered %zu methods.", _handlers.size());
+
+	// Worker: Launch and set active.
+	_worker_alive = true;
+	_worker       = std::thread(std::bind(&streamdeck::server::run, this));
+}
+
+
+void streamdeck::server::handle_connect(std::function<void()> callback) {
+	_connection_handlers.emplace_back(callback);
+}
+
+void streamdeck::server::handle(std::string method, streamdeck::server::handler_callback_t callback)
+{
+	_handlers.insert(std::move(method), {handler_t(std::in_place_type<handler_callback_t>, std::move(callback)),
+										 std::make_shared<method_metrics>()});
+}
+
+void streamdeck::server::handle_sync(std::string method, sync_handler_callback_t callback)
+{
+	_handlers.insert(std::move(method), {handler_t(std::in_place_type<sync_handler_callback_t>, std::move(callback)),
+										 std::make_shared<method_metrics>()});
+}
+
+void streamdeck::server::handle_query(std::string method, sync_handler_callback_t callback,
+									  std::set<std::string> query_params, bool concurrent)
+{
+	_handlers.insert(std::move(method), {handler_t(std::in_place_type<sync_handler_callback_t>, std::move(callback)),
+										 std::make_shared<method_metrics>(), std::move(query_params), std::nullopt,
+										 concurrent});
+}
+
+void streamdeck::server::handle_async(std::string method, streamdeck::server::async_handler_callback_t callback)
+{
+	_handlers.insert(std::move(method), {handler_t(std::in_place_type<async_handler_callback_t>, std::move(callback)),
+										 std::make_shared<method_metrics>()});
+}
+
+void streamdeck::server::set_watch_triggers(std::string method, std::vector<std::string> notifications)
+{
+	if (_handlers.frozen()) {
+		throw std::logic_error("Watch triggers must be registered before the server starts.");
+	}
+	_watch_triggers[std::move(method)] = std::move(notifications);
+}
+
+nlohmann::json streamdeck::server::watch(std::weak_ptr<void> handle, const std::string& method,
+										 const nlohmann::json& params)
+{
+	// Only queries may run at any time, and only those with triggers are evaluated again when something changed.
+	auto entry    = _handlers.find(method);
+	auto triggers = _watch_triggers.find(method);
+	auto callback = entry ? std::get_if<sync_handler_callback_t>(&entry->handler) : nullptr;
+	if (!callback || !entry->query_params || (triggers == _watch_triggers.end())) {
+		throw jsonrpc::invalid_params_error("Method can't be watched.");
+	}
+	if (!is_query(*entry, params)) {
+		throw jsonrpc::invalid_params_error("Watches only take the parameters the method is queried with.");
+	}
+
+	auto watch      = std::make_shared<watch_entry>();
+	watch->handle   = connection_of(handle);
+	watch->callback = callback;
+	watch->triggers = &triggers->second;
+	watch->request  = std::make_shared<streamdeck::jsonrpc::request>();
+	watch->sources  = referenced_sources(params);
+	watch->hash     = 0;
+	watch->pending  = true; // Until the first outcome is known, triggers only mark it dirty.
+	watch->dirty    = false;
+	watch->request->set_method(method);
+	if (!params.is_null()) {
+		watch->request->set_params(params);
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(_watches_lock);
+		size_t                       count = 0;
+		for (auto const& kv : _watches) {
+			if (same_connection(kv.second->handle, watch->handle)) {
+				count++;
+			}
+		}
+		if (count >= WATCH_LIMIT) {
+			throw jsonrpc::invalid_params_error("Too many watches on this connection.");
+		}
+
+		watch->id = ++_watch_next;
+		watch->request->set_id(static_cast<int64_t>(watch->id));
+		_watches.emplace(watch->id, watch);
+		for (auto const& trigger : *watch->triggers) {
+			_watched[trigger]++;
+		}
+		_watches_active++;
+	}
+
+	auto outcome = run_watch(*watch);
+	finish_watch(watch, std::hash<std::string>()(outcome.dump()));
+	outcome["watch"] = watch->id;
+	return outcome;
+}
+
+bool streamdeck::server::unwatch(std::weak_ptr<void> handle, uint64_t id)
+{
+	auto                         connection = connection_of(handle);
+	std::unique_lock<std::mutex> lock(_watches_lock);
+	auto                         iter = _watches.find(id);
+	if ((iter == _watches.end()) || !same_connection(iter->second->handle, connection)) {
+		return false;
+	}
+
+	release_watch(*iter->second);
+	_watches.erase(iter);
+	return true;
+}
+
+void streamdeck::server::notify(std::string method, nlohmann::json params)
+{
+	// Anything still waiting in the coalescing stage for this method is older, so it has to go out first.
+	if (_coalesced_pending > 0) {
+		flush_coalesced(&method);
+	}
+
+	// Watches don't care about subscriptions, so they are triggered either way.
+	trigger_watches(method, params);
+
+	// Skip serialization entirely if nobody is interested in this notification.
+	auto sources = referenced_sources(params);
+	if (!is_deliverable(method, sources)) {
+		_payloads_discarded++;
+		return;
+	}
+
+	enqueue_notification(std::move(method), std::string(), std::move(sources), std::move(params));
+}
+
+void streamdeck::server::notify(std::string method, payload_producer_t producer)
+{
+	// Without sources this only checks the method, source filters are applied once the payload exists. Watches need
+	// the payload as well, for the sources it refers to.
+	if (!is_deliverable(method, {}) && !is_watched(method)) {
+		_payloads_skipped++;
+		return;
+	}
+
+	_payloads_built++;
+	notify(std::move(method), producer());
+}
+
+void streamdeck::server::notify_coalesced(std::string method, std::string key, nlohmann::json params)
+{
+	_coalesce_received++;
+
+	// Watches are triggered once the entry is flushed, only by the latest value.
+	auto sources = referenced_sources(params);
+	if (!is_deliverable(method, sources) && !is_watched(method)) {
+		_coalesce_dropped++;
+		_payloads_discarded++;
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(_coalesce_lock);
+		auto&                        entries = _coalesced[method];
+		auto                         iter    = entries.find(key);
+		if (iter != entries.end()) {
+			iter->second.params  = std::move(params);
+			iter->second.sources = std::move(sources);
+			_coalesce_merged++;
+			return;
+		}
+		entries.emplace(std::move(key), coalesced_entry{std::move(params), std::move(sources)});
+		_coalesced_pending++;
+	}
+
+	// In tick mode the video thread picks this up on the next frame.
+	if (_coalesce_interval > 0) {
+		schedule_coalesced();
+	}
+}
+
+void streamdeck::server::notify_coalesced(std::string method, std::string key, payload_producer_t producer)
+{
+	if (!is_deliverable(method, {}) && !is_watched(method)) {
+		_coalesce_received++;
+		_coalesce_dropped++;
+		_payloads_skipped++;
+		return;
+	}
+
+	_payloads_built++;
+	notify_coalesced(std::move(method), std::move(key), producer());
+}
+
+void streamdeck::server::set_coalesce_interval(std::chrono::milliseconds interval)
+{
+	_coalesce_interval = std::max<int64_t>(interval.count(), 0);
+}
+
+std::chrono::milliseconds streamdeck::server::get_coalesce_interval() const
+{
+	return std::chrono::milliseconds(_coalesce_interval.load());
+}
+
+streamdeck::server::coalesce_stats streamdeck::server::get_coalesce_stats() const
+{
+	return {_coalesce_received.load(), _coalesce_merged.load(), _coalesce_dropped.load(), _coalesce_sent.load()};
+}
+
+streamdeck::server::deflate_stats streamdeck::server::get_deflate_stats() const
+{
+	return {_deflate_messages.load(), _deflate_bytes_in.load(), _deflate_bytes_out.load(), _deflate_time_ns.load()};
+}
+
+streamdeck::server::backlog_stats streamdeck::server::get_backlog_stats() const
+{
+	return {_backlog_deferred.load(), _backlog_merged.load(), _backlog_dropped.load()};
+}
+
+nlohmann::json streamdeck::server::describe_methods() const
+{
+	nlohmann::json result = nlohmann::json::object();
+	_handlers.for_each([&result](const std::string& method, const handler_entry& entry) {
+		nlohmann::json o = nlohmann::json::object();
+		if (entry.params) {
+			o["params"] = params::to_json(*entry.params);
+			o["docs"]   = params::to_markdown(*entry.params);
+		}
+		o["query"]     = entry.query_params.has_value();
+		result[method] = std::move(o);
+	});
+	return result;
+}
+
+nlohmann::json streamdeck::server::get_metrics() const
+{
+	nlohmann::json methods = nlohmann::json::object();
+	_handlers.for_each([&methods](const std::string& method, const handler_entry& entry) {
+		if (entry.metrics->calls.load(std::memory_order_relaxed) > 0) {
+			methods[method] = entry.metrics->to_json();
+		}
+	});
+
+	nlohmann::json transport = nlohmann::json::object();
+	transport["messages_received"] = _messages_received.load();
+	transport["bytes_received"]    = _bytes_received.load();
+	transport["messages_sent"]     = _messages_sent.load();
+	transport["bytes_sent"]        = _bytes_sent.load();
+	transport["invalid_calls"]     = _invalid_calls.load();
+	transport["late_replies"]      = _late_replies.load();
+	transport["parse"]             = _parse_latency.to_json();
+
+	auto           coalesce = get_coalesce_stats();
+	auto           deflate  = get_deflate_stats();
+	auto           backlog  = get_backlog_stats();
+	nlohmann::json result   = nlohmann::json::object();
+	result["methods"]       = methods;
+	result["transport"]     = transport;
+	result["coalesce"]      = {{"received", coalesce.received},
+							   {"merged", coalesce.merged},
+							   {"dropped", coalesce.dropped},
+							   {"sent", coalesce.sent}};
+	result["deflate"]       = {{"messages", deflate.messages},
+							   {"bytes_in", deflate.bytes_in},
+							   {"bytes_out", deflate.bytes_out},
+							   {"time_ns", deflate.time_ns}};
+	result["backlog"] = {{"deferred", backlog.deferred}, {"merged", backlog.merged}, {"dropped", backlog.dropped}};
+	result["payloads"]  = {{"built", _payloads_built.load()},
+						   {"skipped", _payloads_skipped.load()},
+						   {"discarded", _payloads_discarded.load()}};
+	result["keepalive"] = {{"pings", _keepalive_pings.load()}, {"reaped", _keepalive_reaped.load()}};
+	result["watch"]     = {{"active", _watches_active.load()},
+						   {"evaluations", _watch_evaluations.load()},
+						   {"changes", _watch_changes.load()}};
+	return result;
+}
+
+nlohmann::json streamdeck::server::resume(const jsonrpc::client& client, const std::string& session,
+										  uint64_t sequence)
+{
+	nlohmann::json               events = nlohmann::json::array();
+	std::unique_lock<std::mutex> lock(_history_lock);
+
+	// A notification dropped since the last flush_outbound() hasn't been turned into a gap yet.
+	if (_history_gap.exchange(false)) {
+		_history_start = ++_sequence + 1;
+	}
+
+	// Anything from another session, or older than what we still have, needs a full resync. So does anything from
+	// before a detached client was dropped, as notifications only it subscribed to weren't produced since.
+	bool complete = (session == _session) && (sequence <= _sequence) && ((sequence + 1) >= _history_start)
+					&& (sequence >= _history_pruned);
+	if (complete) {
+		for (auto const& entry : _history) {
+			if ((entry.sequence > sequence) && client.is_subscribed(entry.method, entry.sources)) {
+				events.push_back(entry.document);
+			}
+		}
+	}
+
+	nlohmann::json result = nlohmann::json::object();
+	result["session"]     = _session;
+	result["seq"]         = _sequence;
+	result["resync"]      = !complete;
+	result["events"]      = std::move(events);
+	return result;
+}
+
+void streamdeck::server::schedule_coalesced()
+{
+	// Only one flush may be in flight, everything that arrives until then is merged into it.
+	if (_coalesce_scheduled.exchange(true)) {
+		return;
+	}
+
+	int64_t interval = _coalesce_interval;
+	if (interval > 0) {
+		asio::post(*_outbound_strand, [this, interval]() {
+			_ws.set_timer(static_cast<long>(interval), [this](websocketpp::lib::error_code const& ec) {
+				if (!ec) {
+					flush_coalesced();
+				}
+			});
+		});
+	} else {
+		asio::post(*_outbound_strand, [this]() { flush_coalesced(); });
+	}
+}
+
+void streamdeck::server::flush_coalesced(const std::string* method)
+{
+	coalesced_map_t entries;
+	{
+		std::unique_lock<std::mutex> lock(_coalesce_lock);
+		if (method) {
+			auto iter = _coalesced.find(*method);
+			if (iter == _coalesced.end()) {
+				return;
+			}
+			_coalesced_pending -= iter->second.size();
+			entries.emplace(iter->first, std::move(iter->second));
+			_coalesced.erase(iter);
+		} else {
+			// Clear the flag while holding the lock, so that a producer racing with us schedules another flush.
+			_coalesce_scheduled = false;
+			_coalesced_pending  = 0;
+			entries.swap(_coalesced);
+		}
+	}
+
+	for (auto& kv : entries) {
+		for (auto& entry : kv.second) {
+			trigger_watches(kv.first, entry.second.params);
+
+			// Clients may have gone or unsubscribed while the entry was waiting.
+			if (!is_deliverable(kv.first, entry.second.sources)) {
+				_coalesce_dropped++;
+				continue;
+			}
+			_coalesce_sent++;
+			// Still only the latest value matters, should the client fall behind.
+			enqueue_notification(kv.first, kv.first + '\n' + entry.first, std::move(entry.second.sources),
+								 std::move(entry.second.params));
+		}
+	}
+}
+
+void streamdeck::server::on_video_tick(void* ptr, float)
+{
+	auto self = static_cast<streamdeck::server*>(ptr);
+	if ((self->_coalesce_interval == 0) && (self->_coalesced_pending > 0)) {
+		self->schedule_coalesced();
+	}
+}
+
+void streamdeck::server::enqueue_notification(std::string method, std::string key, std::vector<std::string> sources,
+											   nlohmann::json params)
+{
+	streamdeck::jsonrpc::request rq;
+	rq.set_method(method);
+	rq.set_params(std::move(params));
+	rq.clear_id();
+
+	// Encoding depends on the codecs of the receiving clients, so that is left to the worker.
+	outbound_frame frame;
+	frame.broadcast = true;
+	frame.method    = std::move(method);
+	frame.key       = std::move(key);
+	frame.sources   = std::move(sources);
+	frame.document  = rq.release();
+	enqueue(std::move(frame));
+}
+
+bool streamdeck::server::is_subscribed(const std::string& method, const std::vector<std::string>& sources) const
+{
+#ifdef HAVE_EVENT_RING
+	// Readers of the event ring aren't known to the server, they filter on their own.
+	if (_event_ring) {
+		return true;
+	}
+#endif
+
+	auto clients = std::atomic_load(&_clients_snapshot);
+	for (auto const& client : *clients) {
+		if (client->is_subscribed(method, sources)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool streamdeck::server::is_deliverable(const std::string& method, const std::vector<std::string>& sources)
+{
+	if (is_subscribed(method, sources)) {
+		return true;
+	}
+
+	// Nobody is left who could resume, and this notification won't be part of the history. flush_outbound() turns
+	// this into a gap in the sequence numbers.
+	if (std::atomic_load(&_clients_snapshot)->empty()) {
+		_history_gap = true;
+	}
+	return false;
+}
+
+void streamdeck::server::update_clients_snapshot()
+{
+	auto clients = std::make_shared<client_list_t>();
+	clients->reserve(_ws_clients.size());
+	for (auto const& kv : _ws_clients) {
+		clients->push_back(kv.second.client);
+	}
+#ifdef HAVE_LOCAL_TRANSPORT
+	for (auto const& kv : _local_sessions) {
+		clients->push_back(kv.second->client);
+	}
+#endif
+	for (auto const& entry : _detached) {
+		clients->push_back(entry.client);
+	}
+	std::atomic_store(&_clients_snapshot, std::shared_ptr<const client_list_t>(clients));
+}
+
+void streamdeck::server::detach_client(std::shared_ptr<jsonrpc::client> client)
+{
+	// A client that went away still counts as subscribed for a while, so that the notifications it would have
+	// received keep being produced, and end up in the history it can resume from.
+	if (!_worker_alive) {
+		return;
+	}
+	if (_detach_window.count() <= 0) {
+		mark_pruned();
+		return;
+	}
+
+	_detached.push_back({std::move(client), std::chrono::steady_clock::now() + _detach_window});
+	_ws.set_timer(static_cast<long>(_detach_window.count()), [this](websocketpp::lib::error_code const& ec) {
+		if (!ec) {
+			prune_detached();
+		}
+	});
+}
+
+void streamdeck::server::prune_detached()
+{
+	std::unique_lock<std::mutex> lock(_ws_clients_lock);
+	auto                         now     = std::chrono::steady_clock::now();
+	auto                         expired = [now](const detached_client& entry) { return entry.expires <= now; };
+	auto                         end     = std::remove_if(_detached.begin(), _detached.end(), expired);
+	if (end != _detached.end()) {
+		_detached.erase(end, _detached.end());
+		update_clients_snapshot();
+		mark_pruned();
+	}
+}
+
+void streamdeck::server::mark_pruned()
+{
+#ifdef HAVE_EVENT_RING
+	// Everything is produced for the event ring anyway.
+	if (_event_ring) {
+		return;
+	}
+#endif
+
+	// Which of the remaining clients covers what the dropped one subscribed to isn't known, and the client that
+	// resumes can't be told apart from any other. So every resume from before this point has to resync.
+	std::unique_lock<std::mutex> lock(_history_lock);
+	_history_pruned = _sequence;
+}
+
+void streamdeck::server::schedule_keepalive()
+{
+	_ws.set_timer(static_cast<long>(_keepalive_interval.count()), [this](websocketpp::lib::error_code const& ec) {
+		if (!ec) {
+			keepalive();
+		}
+	});
+}
+
+void streamdeck::server::keepalive()
+{
+	if (!_worker_alive) {
+		return;
+	}
+
+	// Anything received recently already proves the client is alive, only quiet ones need a ping.
+	auto now = std::chrono::steady_clock::now();
+	for (auto const& kv : _ws_clients) {
+		if (kv.second.closing || ((now - kv.second.last_seen) < _keepalive_interval)) {
+			continue;
+		}
+
+		websocketpp::lib::error_code ec;
+		_ws.ping(kv.first, std::string(), ec);
+		if (ec) {
+			DLOG(LOG_DEBUG, "Failed to ping client: %s", ec.message().c_str());
+		} else {
+			_keepalive_pings++;
+		}
+	}
+
+	schedule_keepalive();
+}
+
+bool streamdeck::server::is_watched(const std::string& method) const
+{
+	if (_watches_active == 0) {
+		return false;
+	}
+
+	std::unique_lock<std::mutex> lock(_watches_lock);
+	return _watched.count(method) > 0;
+}
+
+void streamdeck::server::trigger_watches(const std::string& method, const nlohmann::json& params)
+{
+	if (_watches_active == 0) {
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(_watches_lock);
+	if (_watched.count(method) == 0) {
+		return;
+	}
+
+	// A watch on the old name of a renamed source has to learn about that too.
+	auto sources = referenced_sources(params);
+	auto from    = params.is_object() ? params.find("from") : params.end();
+	if ((from != params.end()) && from->is_string()) {
+		sources.push_back(from->get<std::string>());
+	}
+
+	for (auto const& kv : _watches) {
+		auto const& watch = kv.second;
+		if (std::find(watch->triggers->begin(), watch->triggers->end(), method) == watch->triggers->end()) {
+			continue;
+		}
+
+		// Both refer to sources, but not to the same ones.
+		if (!sources.empty() && !watch->sources.empty()
+			&& (std::find_first_of(sources.begin(), sources.end(), watch->sources.begin(), watch->sources.end())
+				== sources.end())) {
+			continue;
+		}
+
+		// A burst of triggers results in at most one more evaluation.
+		if (watch->pending) {
+			watch->dirty = true;
+			continue;
+		}
+		watch->pending = true;
+		asio::post(_ws.get_io_service(), std::bind(&streamdeck::server::evaluate_watch, this, watch));
+	}
+}
+
+void streamdeck::server::evaluate_watch(std::shared_ptr<watch_entry> watch)
+{
+	if (!_worker_alive) {
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(_watches_lock);
+		auto                         iter = _watches.find(watch->id);
+		if (iter == _watches.end()) {
+			return;
+		}
+		if (watch->handle.expired()) {
+			release_watch(*watch);
+			_watches.erase(iter);
+			return;
+		}
+	}
+
+	auto outcome = run_watch(*watch);
+	if (!finish_watch(watch, std::hash<std::string>()(outcome.dump()))) {
+		return;
+	}
+	_watch_changes++;
+	outcome["watch"] = watch->id;
+
+	streamdeck::jsonrpc::request rq;
+	rq.set_method("obs.watch.event.changed");
+	rq.set_params(outcome);
+	rq.clear_id();
+
+	// A newer outcome replaces an older one still held back for a slow client.
+	outbound_frame frame;
+	frame.broadcast = false;
+	frame.handle    = watch->handle;
+	frame.key       = "obs.watch\n" + std::to_string(watch->id);
+	frame.document  = rq.release();
+	enqueue(std::move(frame));
+}
+
+nlohmann::json streamdeck::server::run_watch(const watch_entry& watch)
+{
+	_watch_evaluations++;
+
+	auto res = std::make_shared<streamdeck::jsonrpc::response>();
+	res->copy_id(*watch.request);
+	try {
+		(*watch.callback)(watch.request, res);
+	} catch (streamdeck::jsonrpc::error const& ex) {
+		res->set_error(ex.id(), ex.what() ? ex.what() : "Unknown error.");
+	} catch (std::exception const& ex) {
+		res->set_error(streamdeck::jsonrpc::error_codes::INTERNAL_ERROR, ex.what() ? ex.what() : "Unknown error.");
+	}
+
+	// Only the result or error is of interest, the envelope around it is the same every time.
+	auto outcome = res->release();
+	outcome.erase("jsonrpc");
+	outcome.erase("id");
+	return outcome;
+}
+
+bool streamdeck::server::finish_watch(const std::shared_ptr<watch_entry>& watch, size_t hash)
+{
+	std::unique_lock<std::mutex> lock(_watches_lock);
+	if (_watches.count(watch->id) == 0) {
+		return false;
+	}
+
+	bool changed = (hash != watch->hash);
+	watch->hash  = hash;
+	if (watch->dirty) {
+		// Triggered while running, so this outcome may already be outdated.
+		watch->dirty = false;
+		asio::post(_ws.get_io_service(), std::bind(&streamdeck::server::evaluate_watch, this, watch));
+	} else {
+		watch->pending = false;
+	}
+	return changed;
+}
+
+void streamdeck::server::release_watch(const watch_entry& watch)
+{
+	for (auto const& trigger : *watch.triggers) {
+		auto iter = _watched.find(trigger);
+		if ((iter != _watched.end()) && (--iter->second == 0)) {
+			_watched.erase(iter);
+		}
+	}
+	_watches_active--;
+}
+
+void streamdeck::server::remove_watches(const std::weak_ptr<void>& handle)
+{
+	if (_watches_active == 0) {
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(_watches_lock);
+	for (auto iter = _watches.begin(); iter != _watches.end();) {
+		auto const& watch = *iter->second;
+		if (same_connection(watch.handle, handle) || watch.handle.expired()) {
+			release_watch(watch);
+			iter = _watches.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+}
+
+websocketpp::connection_hdl streamdeck::server::connection_of(const std::weak_ptr<void>& handle)
+{
+	// Asynchronous calls from a batch carry a slot handle, which only lives until the batch is answered.
+	if (_batch_slots_active > 0) {
+		std::unique_lock<std::mutex> lock(_batch_slots_lock);
+		auto                         iter = _batch_slots.find(handle);
+		if (iter != _batch_slots.end()) {
+			return iter->second->batch->handle;
+		}
+	}
+	return handle;
+}
+
+void streamdeck::server::reply(std::weak_ptr<void> handle, std::shared_ptr<streamdeck::jsonrpc::response> response)
+{
+	// Each call is answered once, a reply arriving after its deadline already did is dropped. Responses carry their
+	// call along from the request, the scope covers handlers which didn't build theirs with copy_id().
+	auto call = response->get_call();
+	if (!call) {
+		auto scope = streamdeck::call_scope::current();
+		if (scope) {
+			call = scope->state();
+		}
+	}
+	if (call && !call->finish()) {
+		_late_replies++;
+		return;
+	}
+
+	// Replies sent from a task queued by the handler, or from the handler itself, complete the call.
+	auto scope = streamdeck::metrics_scope::current();
+	if (scope && scope->metrics()) {
+		int64_t code;
+		if (response->get_error_code(code)) {
+			scope->metrics()->errors++;
+		}
+		scope->metrics()->total.record(std::chrono::steady_clock::now() - scope->received());
+	}
+
+	// Asynchronous calls from a batch are answered together with the rest of the batch.
+	if (_batch_slots_active > 0) {
+		auto slot = take_batch_slot(handle);
+		if (slot) {
+			slot->batch->responses[slot->index] = response->release();
+			complete_batch(slot->batch);
+			return;
+		}
+	}
+
+	outbound_frame frame;
+	frame.broadcast = false;
+	frame.handle    = handle;
+	frame.document  = response->release();
+	enqueue(std::move(frame));
+}
+
+void streamdeck::server::enqueue(outbound_frame&& frame)
+{
+	_outbound.push(std::move(frame));
+
+	// Only wake the worker if it isn't already going to drain the queue.
+	if (!_outbound_pending.exchange(true)) {
+		asio::post(*_outbound_strand, std::bind(&streamdeck::server::flush_outbound, this));
+	}
+}
+
+void streamdeck::server::flush_outbound()
+{
+	// Clear the flag before draining, so that a producer racing with us schedules another flush.
+	_outbound_pending = false;
+
+	// Some notification was never produced, so nothing before it can be resumed from.
+	if (_history_gap.exchange(false)) {
+		std::unique_lock<std::mutex> lock(_history_lock);
+		_history_start = ++_sequence + 1;
+	}
+
+	outbound_frame frame;
+	while (_outbound.pop(frame)) {
+		if (frame.broadcast) {
+			uint64_t sequence;
+			{
+				std::unique_lock<std::mutex> lock(_history_lock);
+				sequence = ++_sequence;
+			}
+			frame.document["seq"] = sequence;
+
+#ifdef HAVE_EVENT_RING
+			// Under the same sequence number as sent to clients, so that readers can match the two.
+			if (_event_ring) {
+				std::vector<uint8_t> payload;
+				auto                 params = frame.document.find("params");
+				if (params != frame.document.end()) {
+					payload = nlohmann::json::to_msgpack(*params);
+				}
+				if (!_event_ring->write(sequence, frame.method, payload)) {
+					DLOG(LOG_WARNING, "Notification '%s' is too large for the event ring.", frame.method.c_str());
+				}
+			}
+#endif
+			// Encode and frame the document once per codec and compression, no matter how many clients receive it.
+			ws_server_t::message_ptr msgs[CODEC_COUNT][2];
+			for (auto& kv : _ws_clients) {
+				if (kv.second.closing || !kv.second.client->is_subscribed(frame.method, frame.sources)) {
+					continue;
+				}
+				auto& msg = msgs[kv.second.codec][kv.second.deflate ? 1 : 0];
+				if (!msg) {
+					msg = prepare_frame(kv.second.codec, frame.document, kv.second.deflate);
+				}
+				send(kv.first, kv.second, {msg, frame.key, true, 0});
+			}
+#ifdef HAVE_LOCAL_TRANSPORT
+			std::shared_ptr<const std::string> text;
+			for (auto const& kv : _local_sessions) {
+				if (!kv.second->client->is_subscribed(frame.method, frame.sources)) {
+					continue;
+				}
+				if (!text) {
+					text = std::make_shared<const std::string>(frame.document.dump() + '\n');
+				}
+				local_send(kv.second, text, true);
+			}
+#endif
+
+			// Keep it around for obs.session.resume, dropping the oldest once the history is full.
+			std::unique_lock<std::mutex> lock(_history_lock);
+			_history.push_back(
+				{sequence, std::move(frame.method), std::move(frame.sources), std::move(frame.document)});
+			while (_history.size() > _history_limit) {
+				_history_start = _history.front().sequence + 1;
+				_history.pop_front();
+			}
+		} else {
+			auto iter = _ws_clients.find(frame.handle);
+			if (iter != _ws_clients.end()) {
+				auto& info = iter->second;
+				auto  msg  = prepare_frame(info.codec, frame.document, info.deflate);
+				send(iter->first, info, {msg, frame.key, false, 0});
+			}
+#ifdef HAVE_LOCAL_TRANSPORT
+			auto local = _local_sessions.find(frame.handle);
+			if (local != _local_sessions.end()) {
+				local_send(local->second, std::make_shared<const std::string>(frame.document.dump() + '\n'), false);
+			}
+#endif
+		}
+	}
+}
+
+bool streamdeck::server::parse_subprotocol(const std::string& name, codec_type& codec)
+{
+	if (name == WEBSOCKET_PROTOCOL) {
+		codec = codec_type::JSON;
+	} else if (name == WEBSOCKET_PROTOCOL_MSGPACK) {
+		codec = codec_type::MSGPACK;
+	} else if (name == WEBSOCKET_PROTOCOL_CBOR) {
+		codec = codec_type::CBOR;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+nlohmann::json streamdeck::server::decode(codec_type codec, const std::string& payload)
+{
+	switch (codec) {
+	case codec_type::MSGPACK:
+		return nlohmann::json::from_msgpack(payload);
+	case codec_type::CBOR:
+		return nlohmann::json::from_cbor(payload);
+	default:
+		return nlohmann::json::parse(payload);
+	}
+}
+
+std::string streamdeck::server::encode(codec_type codec, const nlohmann::json& document)
+{
+	std::string payload;
+	switch (codec) {
+	case codec_type::MSGPACK:
+		nlohmann::json::to_msgpack(document, payload);
+		break;
+	case codec_type::CBOR:
+		nlohmann::json::to_cbor(document, payload);
+		break;
+	default:
+		payload = document.dump();
+		break;
+	}
+	return payload;
+}
+
+streamdeck::server::ws_server_t::message_ptr streamdeck::server::prepare_frame(codec_type codec,
+																			   const nlohmann::json& document,
+																			   bool                  deflate)
+{
+	// Server frames are never masked, so the framed message is identical for every hybi13 connection. The encoded
+	// payload is swapped in, leaving the copy into the framed buffer as the only one.
+	auto msg = _frame_manager->get_message(
+		(codec == codec_type::JSON) ? websocketpp::frame::opcode::text : websocketpp::frame::opcode::binary, 0);
+	std::string payload = encode(codec, document);
+	msg->get_raw_payload().swap(payload);
+
+	// Small frames aren't worth the latency of compressing them.
+	size_t size = msg->get_payload().size();
+	msg->set_compressed(deflate && (size >= _deflate_threshold));
+
+	auto frame = _frame_manager->get_message();
+	auto start = std::chrono::steady_clock::now();
+	auto ec    = _frame_processor->prepare_data_frame(msg, frame);
+	if (ec) {
+		DLOG(LOG_WARNING, "Failed to prepare frame: %s", ec.message().c_str());
+		return nullptr;
+	}
+	if (msg->get_compressed()) {
+		_deflate_messages++;
+		_deflate_bytes_in += size;
+		_deflate_bytes_out += frame->get_payload().size();
+		_deflate_time_ns += static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+	}
+	return frame;
+}
+
+void streamdeck::server::send(websocketpp::connection_hdl handle, connection_info& info, pending_frame&& frame)
+{
+	if (!frame.frame || info.closing) {
+		return;
+	}
+
+	// Fast path: The client keeps up, hand the frame straight to websocketpp.
+	if (info.backlog.empty() && try_send(handle, info, frame.frame)) {
+		return;
+	}
+
+	// The client is over its budget. Hold the frame back, and keep only the newest value of mergeable ones. The older
+	// value is removed instead of overwritten, so that the newest one stays behind anything queued in the meantime.
+	_backlog_deferred++;
+	if (!frame.key.empty()) {
+		for (auto iter = info.backlog.begin(); iter != info.backlog.end(); iter++) {
+			if (iter->key == frame.key) {
+				info.backlog.erase(iter);
+				_backlog_merged++;
+				break;
+			}
+		}
+	}
+
+	if (frame.droppable && (info.backlog.size() >= _backlog_messages)) {
+		// Let the client know it missed something, so that it can query the current state again.
+		_backlog_dropped++;
+		for (auto& entry : info.backlog) {
+			if (entry.overflow > 0) {
+				entry.overflow++;
+				entry.frame = nullptr;
+				return;
+			}
+		}
+		info.backlog.push_back({nullptr, std::string(), false, 1});
+	} else {
+		info.backlog.push_back(std::move(frame));
+	}
+
+	if (!_backlog_scheduled) {
+		_backlog_scheduled = true;
+		_ws.set_timer(BACKLOG_RETRY_MS, [this](websocketpp::lib::error_code const& ec) {
+			_backlog_scheduled = false;
+			if (!ec) {
+				flush_backlogs();
+			}
+		});
+	}
+}
+
+bool streamdeck::server::try_send(websocketpp::connection_hdl handle, const connection_info& info,
+								  const ws_server_t::message_ptr& frame)
+{
+	websocketpp::lib::error_code ec;
+	auto                         con = _ws.get_con_from_hdl(handle, ec);
+	if (ec) { // Connection is already gone, nothing left to wait for.
+		return true;
+	}
+
+	// A frame larger than the whole budget still goes out once the buffer is empty.
+	size_t buffered = con->get_buffered_amount();
+	if ((buffered > 0) && ((buffered + frame->get_payload().size()) > _backlog_bytes)) {
+		return false;
+	}
+
+#ifdef _DEBUG
+	if (frame->get_opcode() == websocketpp::frame::opcode::text) {
+		DLOG(LOG_DEBUG, "<%s> Send \"%s\"", con->get_remote_endpoint().c_str(), frame->get_payload().c_str());
+	} else {
+		DLOG(LOG_DEBUG, "<%s> Send %zu bytes", con->get_remote_endpoint().c_str(), frame->get_payload().size());
+	}
+#endif
+	_messages_sent++;
+	_bytes_sent += frame->get_payload().size();
+	if (info.shared_frames) {
+		con->send(frame);
+	} else {
+		con->send(frame->get_payload(), frame->get_opcode());
+	}
+	return true;
+}
+
+bool streamdeck::server::flush_backlog(websocketpp::connection_hdl handle, connection_info& info)
+{
+	while (!info.backlog.empty()) {
+		auto& entry = info.backlog.front();
+		if (!entry.frame && (entry.overflow > 0)) {
+			streamdeck::jsonrpc::request rq;
+			rq.set_method("obs.system.event.overflow");
+			rq.set_params({{"dropped", entry.overflow}});
+			rq.clear_id();
+			entry.frame = prepare_frame(info.codec, rq.release(), info.deflate);
+		}
+		if (entry.frame && !try_send(handle, info, entry.frame)) {
+			return false;
+		}
+		info.backlog.pop_front();
+	}
+	return true;
+}
+
+void streamdeck::server::flush_backlogs()
+{
+	bool pending = false;
+	for (auto& kv : _ws_clients) {
+		if (!kv.second.closing && !flush_backlog(kv.first, kv.second)) {
+			pending = true;
+		}
+	}
+
+	// Keep retrying until every client has caught up.
+	if (pending && !_backlog_scheduled) {
+		_backlog_scheduled = true;
+		_ws.set_timer(BACKLOG_RETRY_MS, [this](websocketpp::lib::error_code const& ec) {
+			_backlog_scheduled = false;
+			if (!ec) {
+				flush_backlogs();
+			}
+		});
+	}
+}
+
+void streamdeck::server::run()
+{
+	// Build the appropriate endpoint.
+	asio::ip::tcp::endpoint ep;
+	ep.address(asio::ip::address_v4::loopback());
+	std::string address = ep.address().to_string();
+
+	// Try each well-known port once, so that clients probing them still find us. The list ends in 0, which lets the
+	// system pick any free port should all of them be taken, e.g. by another OBS instance.
+	websocketpp::lib::error_code ec;
+	for (size_t idx = 0;; idx++) {
+		ep.port(WEBSOCKET_PORTS[idx]);
+		_ws.listen(ep, ec);
+		if (!ec || (WEBSOCKET_PORTS[idx] == 0)) {
+			break;
+		}
+		DLOG(LOG_DEBUG, "Port %" PRIu16 " is unavailable: %s", uint16_t(ep.port()), ec.message().c_str());
+	}
+	if (ec) {
+		DLOG(LOG_ERROR, "Failed to listen on '%s': %s", address.c_str(), ec.message().c_str());
+		return;
+	}
+
+	auto local = _ws.get_local_endpoint(ec);
+	if (!ec) {
+		ep.port(local.port());
+	}
+	DLOG(LOG_INFO, "Listening on '%s:%" PRIu16 "'.", address.c_str(), uint16_t(ep.port()));
+#ifdef HAVE_LOCAL_TRANSPORT
+	if (_local_enabled) {
+		local_start();
+	}
+#endif
+#ifdef HAVE_EVENT_RING
+	if (_event_ring_size > 0) {
+		try {
+			_event_ring = std::make_unique<streamdeck::event_ring>(
+				"/" WEBSOCKET_PROTOCOL "-" + std::to_string(process_id()), _event_ring_size);
+			DLOG(LOG_INFO, "Mirroring notifications to shared memory '%s' (%zu bytes).", _event_ring->name().c_str(),
+				 _event_ring->capacity());
+		} catch (std::exception const& ex) {
+			DLOG(LOG_WARNING, "Failed to create shared memory event ring: %s", ex.what());
+		}
+	}
+#endif
+	write_discovery_file(address, ep.port());
 
-/* clang-format off */
-#define DLOG(LEVEL, ...) streamdeck::message(streamdeck::log_level:: LEVEL, "[Server] " __VA_ARGS__)
-/* clang-format on */
+	// Start accepting new connections.
+	_ws.start_accept();
+	if (_keepalive_interval.count() > 0) {
+		schedule_keepalive();
+	}
 
-streamdeck::server::~server()
+	// Perform work until stopped. The perpetual flag keeps the io_context alive while idle, so run() blocks in the
+	// reactor instead of spinning, and handlers are invoked as soon as the socket is ready.
+	if (_worker_alive) {
+		_ws.start_perpetual();
+		_ws.run();
+	}
+
+	remove_discovery_file();
+#ifdef HAVE_EVENT_RING
+	_event_ring.reset();
+#endif
+}
+
+void streamdeck::server::write_discovery_file(const std::string& address, unsigned short port)
 {
-	DLOG(LOG_DEBUG, "Destroying WebSocket handler...");
+	// One file per instance, named after the process, so that several OBS instances can run side by side.
+	unsigned long pid = process_id();
 
-	if (_ws.is_listening()) {
-		// WebSocket: Stop listening.
-		_ws.stop_listening();
+	char* directory = obs_module_config_path(DISCOVERY_DIRECTORY);
+	char* path      = obs_module_config_path((DISCOVERY_DIRECTORY "/" + std::to_string(pid) + ".json").c_str());
+	if (directory && path) {
+		nlohmann::json data = nlohmann::json::object();
+		data["pid"]         = pid;
+		data["address"]     = address;
+		data["port"]        = port;
+		data["protocols"]   = {WEBSOCKET_PROTOCOL, WEBSOCKET_PROTOCOL_MSGPACK, WEBSOCKET_PROTOCOL_CBOR};
+#ifdef HAVE_LOCAL_TRANSPORT
+		if (!_local_path.empty()) {
+			data["socket"] = _local_path;
+		}
+#endif
+#ifdef HAVE_EVENT_RING
+		if (_event_ring) {
+			data["ring"] = _event_ring->name();
+		}
+#endif
+		std::string text    = data.dump(4);
 
-		// WebSocket: Disconnect any clients.
-		for (auto handle : _ws_clients) { // !TODO!
-			auto con = _ws.get_con_from_hdl(handle.first);
-			_ws.close(con, websocketpp::close::status::going_away, "Shutting down.");
+		// Written to a temporary file first and then moved into place, so clients never see a partial file.
+		os_mkdirs(directory);
+		if (os_quick_write_utf8_file_safe(path, text.c_str(), text.size(), false, "tmp", nullptr)) {
+			_discovery_file = path;
+		} else {
+			DLOG(LOG_WARNING, "Failed to write discovery file '%s'.", path);
 		}
 	}
-
-	// Worker: Signal to stop and join.
-	_worker_alive = false;
-	if (_worker.joinable())
-		_worker.join();
+	bfree(path);
+	bfree(directory);
 }
 
-streamdeck::server::server()
-	: _ws(),
-
-	  _worker(), _worker_alive(true)
+void streamdeck::server::remove_discovery_file()
 {
-	DLOG(LOG_DEBUG, "Creating WebSocket handler...");
+	if (!_discovery_file.empty()) {
+		os_unlink(_discovery_file.c_str());
+		_discovery_file.clear();
+	}
+}
 
-	// WebSocket: Initialize.
-	_ws.set_access_channels(websocketpp::log::alevel::all ^ websocketpp::log::alevel::frame_payload);
-	_ws.set_error_channels(websocketpp::log::elevel::all);
-	_ws.set_listen_backlog(1);
-	_ws.init_asio();
+void streamdeck::server::shutdown()
+{
+	// WebSocket: Stop listening.
+	if (_ws.is_listening()) {
+		websocketpp::lib::error_code ec;
+		_ws.stop_listening(ec);
+	}
+	_ws.stop_perpetual();
+#ifdef HAVE_LOCAL_TRANSPORT
+	local_stop();
+#endif
 
-	// WebSocket: Set callbacks.
-	_ws.set_validate_handler(std::bind(&streamdeck::server::ws_on_validate, this, std::placeholders::_1));
-	_ws.set_open_handler(std::bind(&streamdeck::server::ws_on_open, this, std::placeholders::_1));
-	_ws.set_message_handler(
-		std::bind(&streamdeck::server::ws_on_message, this, std::placeholders::_1, std::placeholders::_2));
-	_ws.set_close_handler(std::bind(&streamdeck::server::ws_on_close, this, std::placeholders::_1));
+	if (_ws_clients.empty()) {
+		_ws.stop();
+		return;
+	}
 
-	// Worker: Launch and set active.
-	_worker_alive = true;
-	_worker       = std::thread(std::bind(&streamdeck::server::run, this));
+	// WebSocket: Disconnect any clients, and give them a moment to acknowledge.
+	for (auto& kv : _ws_clients) {
+		websocketpp::lib::error_code ec;
+		kv.second.closing = true;
+		_ws.close(kv.first, websocketpp::close::status::going_away, "Shutting down.", ec);
+	}
+	_ws.set_timer(SHUTDOWN_TIMEOUT_MS, [this](websocketpp::lib::error_code const&) { _ws.stop(); });
 }
 
+#ifdef HAVE_LOCAL_TRANSPORT
+void streamdeck::server::local_start()
+{
+	// Next to the discovery file, in a directory only the user running OBS may enter. Restricting the socket itself
+	// after binding it would leave a moment in which anybody could connect.
+	char* directory = obs_module_config_path(DISCOVERY_DIRECTORY);
+	char* path = obs_module_config_path((DISCOVERY_DIRECTORY "/" + std::to_string(process_id()) + ".sock").c_str());
+	if (directory && path) {
+		os_mkdirs(directory);
+		::unlink(path); // Left behind by a crashed instance with the same process id.
 
-void streamdeck::server::handle_connect(std::function<void()> callback) {
-	_connection_handlers.emplace_back(callback);
+		if (::chmod(directory, S_IRWXU) != 0) {
+			DLOG(LOG_WARNING, "Failed to restrict access to '%s', not listening on a local socket.", directory);
+		} else {
+			try {
+				asio::local::stream_protocol::endpoint ep(path);
+				_local_acceptor = std::make_unique<asio::local::stream_protocol::acceptor>(_ws.get_io_service(), ep);
+				_local_path     = path;
+				DLOG(LOG_INFO, "Listening on '%s'.", path);
+				local_accept();
+			} catch (std::exception const& ex) {
+				// Socket paths are limited to around 100 characters, which a long home directory can exceed.
+				DLOG(LOG_WARNING, "Failed to listen on '%s': %s", path, ex.what());
+				_local_acceptor.reset();
+			}
+		}
+	}
+	bfree(path);
+	bfree(directory);
 }
 
-void streamdeck::server::handle(std::string method, streamdeck::server::handler_callback_t callback)
+void streamdeck::server::local_stop()
 {
-	_methods.emplace(method, handler_type::DEFAULT);
-	_handler_default.emplace(method, callback);
-}
+	if (_local_acceptor) {
+		asio::error_code ec;
+		_local_acceptor->close(ec);
+	}
 
-void streamdeck::server::handle_sync(std::string method, sync_handler_callback_t callback)
-{
-	_methods.emplace(method, handler_type::SYNCHRONOUS);
-	_handler_sync.emplace(method, callback);
-}
+	auto sessions = _local_sessions;
+	for (auto const& kv : sessions) {
+		local_close(kv.second);
+	}
 
-void streamdeck::server::handle_async(std::string method, streamdeck::server::async_handler_callback_t callback)
-{
-	_methods.emplace(method, handler_type::ASYNCHRONOUS);
-	_handler_async.emplace(method, callback);
+	if (!_local_path.empty()) {
+		::unlink(_local_path.c_str());
+		_local_path.clear();
+	}
 }
 
-void streamdeck::server::notify(std::string method, nlohmann::json params)
+void streamdeck::server::local_accept()
 {
-	streamdeck::jsonrpc::request rq;
-	rq.set_method(method);
-	rq.set_params(params);
-	rq.clear_id();
+	auto session = std::make_shared<local_session>(_ws.get_io_service(), LOCAL_MESSAGE_SIZE_MAX);
+	_local_acceptor->async_accept(session->socket, [this, session](asio::error_code const& ec) {
+		if (ec) { // Acceptor was closed.
+			return;
+		}
 
-	auto str = rq.compile().dump();
-	for (auto handle : _ws_clients) { // !TODO!
-		auto con = _ws.get_con_from_hdl(handle.first);
+		{
+			std::unique_lock<std::mutex> lock(_ws_clients_lock);
+			_local_sessions.emplace(session, session);
+			update_clients_snapshot();
+		}
+		for (const auto& handler : _connection_handlers) {
+			handler();
+		}
 #ifdef _DEBUG
-		DLOG(LOG_DEBUG, "<%s> Notify \"%s\"", con->get_remote_endpoint().c_str(), str.c_str());
+		DLOG(LOG_DEBUG, "New local Client");
 #endif
-		con->send(str, websocketpp::frame::opcode::text);
-	}
+
+		local_read(session);
+		local_accept();
+	});
 }
 
-void streamdeck::server::reply(std::weak_ptr<void> handle, std::shared_ptr<streamdeck::jsonrpc::response> response)
+void streamdeck::server::local_read(std::shared_ptr<local_session> session)
 {
-	auto str = response->compile().dump();
-	auto con = _ws.get_con_from_hdl(handle);
-#ifdef _DEBUG
-	DLOG(LOG_DEBUG, "<%s> Async Reply \"%s\"", con->get_remote_endpoint().c_str(), str.c_str());
-#endif
-	con->send(str, websocketpp::frame::opcode::text);
+	asio::async_read_until(session->socket, session->input, '\n',
+						   [this, session](asio::error_code const& ec, size_t) {
+							   if (ec) { // Closed by either side, or the message was too large.
+								   local_close(session);
+								   return;
+							   }
+
+							   std::string  payload;
+							   std::istream stream(&session->input);
+							   std::getline(stream, payload);
+							   local_on_message(session, payload);
+							   local_read(session);
+						   });
 }
 
-void streamdeck::server::run()
+void streamdeck::server::local_on_message(const std::shared_ptr<local_session>& session, const std::string& payload)
 {
-	// Build the appropriate endpoint.
-	asio::ip::tcp::endpoint ep;
-	unsigned short          portIdx    = 0;
-	unsigned short          listenPort = WEBSOCKET_PORTS[portIdx];
+	if (payload.find_first_not_of(" \t\r") == std::string::npos) {
+		return;
+	}
 
-	ep.address(asio::ip::address_v4::loopback());
-	ep.port(listenPort);
-	std::string address = ep.address().to_string();
+	auto received = std::chrono::steady_clock::now();
+	_messages_received++;
+	_bytes_received += payload.size() + 1;
 
-	// Try to listen for new connections for 30 seconds.
-	uint64_t                                       attempts = 0;
-	std::chrono::high_resolution_clock::time_point start    = std::chrono::high_resolution_clock::now();
-	while (((std::chrono::high_resolution_clock::now() - start) < std::chrono::seconds(30)) && _worker_alive) {
-		try {
-			_ws.listen(ep);
-			break;
-		} catch (std::exception const& ex) {
-			attempts++;
-			if (attempts % 100 == 0) {
-				DLOG(LOG_WARNING, "Attempt %" PRIu64 " at listening on '%s:%" PRIu16 "' failed with exception: %s",
-					 attempts, address.c_str(), uint16_t(ep.port()), ex.what());
-			}
-			listenPort = WEBSOCKET_PORTS[portIdx++];
-			if (listenPort == 0) {
-				portIdx    = 0;
-				listenPort = WEBSOCKET_PORTS[portIdx];
-			}
-			ep.port(listenPort);
-			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	try {
+		nlohmann::json input = decode(codec_type::JSON, payload);
+		_parse_latency.record(std::chrono::steady_clock::now() - received);
+		if (input.is_array()) {
+			// Group Call, answered as a whole once every entry is done.
+			handle_batch(session, session->client, std::move(input), received);
+			return;
 		}
+
+		// Solo Call
+		nlohmann::json output = handle_call(session, session->client.get(), std::move(input), received);
+		if (output.is_object()) {
+			local_send(session, std::make_shared<const std::string>(output.dump() + '\n'), false);
+		}
+	} catch (std::exception const& ex) {
+		DLOG(LOG_WARNING, "<local> Exception: %s", ex.what());
 	}
-	if (!_ws.is_listening()) {
-		DLOG(LOG_ERROR, "Failed to listen on '%s:%" PRIu16 "' after 30 seconds.", address.c_str(), uint16_t(ep.port()));
+}
+
+void streamdeck::server::local_send(const std::shared_ptr<local_session>& session,
+									std::shared_ptr<const std::string> payload, bool droppable)
+{
+	// There is no merging here, a local client over its budget simply misses notifications until it catches up.
+	if (droppable && (session->output_bytes > _backlog_bytes)) {
+		session->dropped++;
+		_backlog_dropped++;
 		return;
-	} else {
-		DLOG(LOG_INFO, "Listening on '%s:%" PRIu16 "'.", address.c_str(), uint16_t(ep.port()));
 	}
 
-	// Start accepting new connections.
-	_ws.start_accept();
+	_messages_sent++;
+	_bytes_sent += payload->size();
+
+	bool idle = session->output.empty();
+	session->output_bytes += payload->size();
+	session->output.push_back(std::move(payload));
+	if (idle) {
+		local_write(session);
+	}
+}
+
+void streamdeck::server::local_write(std::shared_ptr<local_session> session)
+{
+	auto const& payload = session->output.front();
+	asio::async_write(session->socket, asio::buffer(*payload), [this, session](asio::error_code const& ec, size_t) {
+		if (ec) {
+			local_close(session);
+			return;
+		}
+
+		session->output_bytes -= session->output.front()->size();
+		session->output.pop_front();
 
-	// Perform work
-	while (_worker_alive) {
-		while (_ws.poll_one() != 0) {
-			_ws.run_one();
+		// Let the client know it missed something, so that it can query the current state again.
+		if (session->output.empty() && (session->dropped > 0)) {
+			streamdeck::jsonrpc::request rq;
+			rq.set_method("obs.system.event.overflow");
+			rq.set_params({{"dropped", session->dropped}});
+			rq.clear_id();
+			session->dropped = 0;
+			local_send(session, std::make_shared<const std::string>(rq.release().dump() + '\n'), false);
+			return;
 		}
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		if (!session->output.empty()) {
+			local_write(session);
+		}
+	});
+}
+
+void streamdeck::server::local_close(const std::shared_ptr<local_session>& session)
+{
+	asio::error_code ec;
+	session->socket.close(ec);
+	remove_watches(session);
+	drop_batch_slots(session);
+
+	std::unique_lock<std::mutex> lock(_ws_clients_lock);
+	if (_local_sessions.erase(session) > 0) {
+		detach_client(session->client);
+		update_clients_snapshot();
+#ifdef _DEBUG
+		DLOG(LOG_DEBUG, "Lost local Client");
+#endif
 	}
 }
+#endif
 
-nlohmann::json streamdeck::server::handle_call(websocketpp::connection_hdl handle, nlohmann::json& request)
+nlohmann::json streamdeck::server::handle_call(websocketpp::connection_hdl handle, jsonrpc::client* client,
+											   nlohmann::json&& request, std::chrono::steady_clock::time_point received)
 {
 	std::shared_ptr<streamdeck::jsonrpc::request>  req;
-	std::shared_ptr<streamdeck::jsonrpc::response> res_allocated = std::make_shared<streamdeck::jsonrpc::response>();
-	std::shared_ptr<streamdeck::jsonrpc::response> res           = res_allocated;
+	std::shared_ptr<streamdeck::jsonrpc::response> res; // Only allocated once there is something to reply with.
+	std::shared_ptr<method_metrics>                metrics;
+	std::optional<streamdeck::metrics_scope>       scope;
+	auto                                           started = std::chrono::steady_clock::now();
 
 	try {
-		auto clientIter = _ws_clients.find(handle);
-		jsonrpc::client* client = nullptr;
-		if (clientIter != _ws_clients.end()) {
-			client = clientIter->second;
-		}
-		req = std::make_shared<streamdeck::jsonrpc::request>(request, client);
+		req = std::make_shared<streamdeck::jsonrpc::request>(std::move(request), client);
+		req->set_handle(handle);
 
 		// Figure out the type of handler we have.
 		std::string method = req->get_method();
-		auto        mf     = _methods.find(method);
-		if (mf != _methods.end()) {
-			if (mf->second == handler_type::ASYNCHRONOUS) {
-				auto itr = _handler_async.find(method);
-				if (itr != _handler_async.end()) {
-					itr->second(handle, req);
-					// Skip all other processing, as asynchronous calls have a delayed response.
-					return nlohmann::json();
-				} else {
-					throw streamdeck::jsonrpc::internal_error("Failed to find asynchronous handler.");
-				}
-			} else if (mf->second == handler_type::SYNCHRONOUS) {
-				auto itr = _handler_sync.find(method);
-				if (itr != _handler_sync.end()) {
-					res_allocated->copy_id(*req);
-					itr->second(req, res_allocated);
-				} else {
-					throw streamdeck::jsonrpc::internal_error("Failed to find synchronous handler.");
-				}
-			} else if (mf->second == handler_type::DEFAULT) {
-				auto itr = _handler_default.find(method);
-				if (itr != _handler_default.end()) {
-					res = itr->second(req);
-					if (!res) {
-						res = res_allocated;
-						res->copy_id(*(req.get()));
-						res->set_result(nlohmann::json());
-					}
-				} else {
-					throw streamdeck::jsonrpc::internal_error("Failed to find default handler.");
-				}
-			} else {
-				throw streamdeck::jsonrpc::internal_error("Failed to resolve method handler.");
+		auto        entry  = _handlers.find(method);
+		if (!entry) {
+			throw streamdeck::jsonrpc::method_not_found_error("Method is unknown to us.");
+		}
+		auto handler = &entry->handler;
+
+		// Anything the handler queues or replies from here on counts towards this method.
+		metrics = entry->metrics;
+		metrics->calls++;
+		scope.emplace(metrics, received);
+
+		if (auto callback = std::get_if<async_handler_callback_t>(handler)) {
+			// Everything the handler queues shares this state, so that it can be skipped once the call is moot.
+			std::chrono::milliseconds timeout;
+			auto                      deadline = std::chrono::steady_clock::time_point::max();
+			if (req->get_timeout(timeout)) {
+				deadline = received + timeout;
+			}
+			auto call = std::make_shared<call_state>(handle, deadline);
+			req->set_call(call);
+			if (deadline != std::chrono::steady_clock::time_point::max()) {
+				schedule_deadline(call, handle, req, metrics, received);
+			}
+
+			try {
+				streamdeck::call_scope scope_call(call);
+				(*callback)(handle, req);
+			} catch (...) {
+				// Answered right here with the error, the deadline must not answer it again.
+				call->finish();
+				throw;
+			}
+			metrics->dispatch.record(std::chrono::steady_clock::now() - started);
+			// Skip all other processing, as asynchronous calls have a delayed response.
+			return nlohmann::json();
+		} else if (auto callback = std::get_if<sync_handler_callback_t>(handler)) {
+			res = std::make_shared<streamdeck::jsonrpc::response>();
+			res->copy_id(*req);
+			(*callback)(req, res);
+		} else if (auto callback = std::get_if<handler_callback_t>(handler)) {
+			res = (*callback)(req);
+			if (!res) {
+				res = std::make_shared<streamdeck::jsonrpc::response>();
+				res->copy_id(*req);
+				res->set_result(nlohmann::json());
 			}
 		} else {
-			throw streamdeck::jsonrpc::method_not_found_error("Method is unknown to us.");
+			throw streamdeck::jsonrpc::internal_error("Failed to resolve method handler.");
 		}
 	} catch (streamdeck::jsonrpc::error const& ex) {
-		res->copy_id(*req);
-		res->set_error(ex.id(), ex.what() ? ex.what() : "Unknown error.");
+		res = error_response(req, ex.id(), ex.what());
 	} catch (nlohmann::json::parse_error const& ex) {
-		res->copy_id(*req);
-		res = std::make_shared<streamdeck::jsonrpc::response>();
-		res->set_error(streamdeck::jsonrpc::error_codes::INVALID_REQUEST, ex.what() ? ex.what() : "Unknown error.");
+		res = error_response(nullptr, streamdeck::jsonrpc::error_codes::INVALID_REQUEST, ex.what());
 	} catch (std::exception const& ex) {
-		res->copy_id(*req);
-		res->set_error(streamdeck::jsonrpc::error_codes::INTERNAL_ERROR, ex.what() ? ex.what() : "Unknown error.");
+		res = error_response(req, streamdeck::jsonrpc::error_codes::INTERNAL_ERROR, ex.what());
 	}
 	try {
 		res->validate();
 	} catch (streamdeck::jsonrpc::error const& ex) {
-		res->copy_id(*req);
-		res->set_error(streamdeck::jsonrpc::error_codes::INTERNAL_ERROR, ex.what() ? ex.what() : "Unknown error.");
+		res = error_response(req, streamdeck::jsonrpc::error_codes::INTERNAL_ERROR, ex.what());
 	} catch (nlohmann::json::parse_error const& ex) {
-		res->copy_id(*req);
-		res->set_error(streamdeck::jsonrpc::error_codes::INTERNAL_ERROR, ex.what() ? ex.what() : "Unknown error.");
+		res = error_response(req, streamdeck::jsonrpc::error_codes::INTERNAL_ERROR, ex.what());
 	}
-	return res->compile();
+
+	if (metrics) {
+		auto    finished = std::chrono::steady_clock::now();
+		int64_t code;
+		if (res->get_error_code(code)) {
+			metrics->errors++;
+		}
+		metrics->dispatch.record(finished - started);
+		metrics->total.record(finished - received);
+	} else {
+		_invalid_calls++;
+	}
+	return res->release();
 }
 
 bool streamdeck::server::ws_on_validate(websocketpp::connection_hdl handle)
@@ -259,10 +1790,12 @@ bool streamdeck::server::ws_on_validate(websocketpp::connection_hdl handle)
 	auto con = _ws.get_con_from_hdl(handle);
 
 	{ // Validate SubProtocols
-		auto sps     = con->get_requested_subprotocols();
-		bool have_sp = false;
+		// Clients list their preferred encoding first, and may fall back to plain JSON.
+		auto       sps     = con->get_requested_subprotocols();
+		bool       have_sp = false;
+		codec_type codec;
 		for (auto sp : sps) {
-			if (sp == WEBSOCKET_PROTOCOL) {
+			if (parse_subprotocol(sp, codec)) {
 				con->select_subprotocol(sp);
 				have_sp = true;
 				break;
@@ -277,11 +1810,28 @@ bool streamdeck::server::ws_on_validate(websocketpp::connection_hdl handle)
 
 void streamdeck::server::ws_on_open(websocketpp::connection_hdl handle)
 { // Client connected to us, do things with it.
-	// Track the new client.
-	_ws_clients.emplace(handle, new jsonrpc::client());
-
 	auto con = _ws.get_con_from_hdl(handle);
 
+	// Track the new client. Legacy hybi00 clients don't send a version and use different framing, so they can't share
+	// prepared frames with everyone else.
+	{
+		std::unique_lock<std::mutex> lock(_ws_clients_lock);
+		connection_info              info;
+		info.client        = std::make_shared<jsonrpc::client>();
+		info.codec         = codec_type::JSON;
+		info.closing       = false;
+		info.last_seen     = std::chrono::steady_clock::now();
+		parse_subprotocol(con->get_subprotocol(), info.codec);
+		info.shared_frames = !con->get_request_header("Sec-WebSocket-Version").empty();
+
+		// Shared compressed frames use the full window, so they can't go to clients that asked for a smaller one.
+		auto extensions = con->get_response_header("Sec-WebSocket-Extensions");
+		info.deflate    = info.shared_frames && (extensions.find("permessage-deflate") != std::string::npos)
+					   && (extensions.find("server_max_window_bits") == std::string::npos);
+		_ws_clients.emplace(handle, std::move(info));
+		update_clients_snapshot();
+	}
+
 	auto host = con->get_remote_endpoint();
 
 	for (const auto& handler : _connection_handlers) {
@@ -295,12 +1845,17 @@ void streamdeck::server::ws_on_open(websocketpp::connection_hdl handle)
 void streamdeck::server::ws_on_close(websocketpp::connection_hdl handle)
 { // Server disconnected from us,
 	// Untrack the client.
-	auto iter = _ws_clients.find(handle);
-	if (iter != _ws_clients.end()) {
-		delete iter->second;
+	{
+		std::unique_lock<std::mutex> lock(_ws_clients_lock);
+		auto                         iter = _ws_clients.find(handle);
+		if (iter != _ws_clients.end()) {
+			detach_client(iter->second.client);
+			_ws_clients.erase(iter);
+			update_clients_snapshot();
+		}
 	}
-
-	_ws_clients.erase(handle);
+	remove_watches(handle);
+	drop_batch_slots(handle);
 
 	auto con = _ws.get_con_from_hdl(handle);
 
@@ -308,39 +1863,75 @@ void streamdeck::server::ws_on_close(websocketpp::connection_hdl handle)
 #ifdef _DEBUG
 	DLOG(LOG_DEBUG, "Lost Client %s", host.c_str());
 #endif
+
+	// If we are shutting down, stop as soon as the last client is gone.
+	if (!_worker_alive && _ws_clients.empty()) {
+		_ws.stop();
+	}
+}
+
+void streamdeck::server::ws_on_pong(websocketpp::connection_hdl handle, std::string)
+{
+	auto iter = _ws_clients.find(handle);
+	if (iter != _ws_clients.end()) {
+		iter->second.last_seen = std::chrono::steady_clock::now();
+	}
+}
+
+void streamdeck::server::ws_on_pong_timeout(websocketpp::connection_hdl handle, std::string)
+{
+	// The peer is gone without saying so. It stays tracked until the close handshake times out as well and
+	// ws_on_close() untracks it like any other client, but nothing is prepared or sent for it in the meantime.
+	auto iter = _ws_clients.find(handle);
+	if (iter != _ws_clients.end()) {
+		iter->second.closing = true;
+		iter->second.backlog.clear();
+	}
+	_keepalive_reaped++;
+	DLOG(LOG_INFO, "Client did not answer a ping within %" PRId64 " ms, closing.",
+		 static_cast<int64_t>(_keepalive_timeout.count()));
+
+	websocketpp::lib::error_code ec;
+	_ws.close(handle, websocketpp::close::status::going_away, "Keepalive timed out.", ec);
 }
 
 void streamdeck::server::ws_on_message(websocketpp::connection_hdl handle, ws_server_t::message_ptr msg)
 {
-	auto con = _ws.get_con_from_hdl(handle);
+	auto con  = _ws.get_con_from_hdl(handle);
+	auto iter = _ws_clients.find(handle);
+	if (iter == _ws_clients.end()) {
+		return;
+	}
+	connection_info& info     = iter->second;
+	auto             received = std::chrono::steady_clock::now();
+	info.last_seen            = received;
+	_messages_received++;
+	_bytes_received += msg->get_payload().size();
+
 	try {
-		nlohmann::json input = nlohmann::json::parse(msg->get_payload());
-		std::string    output;
+		nlohmann::json input = decode(info.codec, msg->get_payload());
+		_parse_latency.record(std::chrono::steady_clock::now() - received);
 		if (input.is_array()) {
-			// Group Call
-			nlohmann::json responses = nlohmann::json::array();
-			for (auto idx = 0; idx < input.size(); idx++) {
-				nlohmann::json entry = input.at(idx);
-				auto           obj   = handle_call(handle, entry);
-				if (obj.is_object()) {
-					responses.emplace_back(obj);
-				}
-			}
-			output = responses.dump();
-		} else {
-			// Solo Call
-			auto obj = handle_call(handle, input);
-			if (obj.is_object()) {
-				output = obj.dump();
-			}
+			// Group Call, answered as a whole once every entry is done.
+#ifdef _DEBUG
+			DLOG(LOG_DEBUG, "<%s> Batch Query \"%s\"", con->get_remote_endpoint().c_str(), input.dump().c_str());
+#endif
+			handle_batch(handle, info.client, std::move(input), received);
+			return;
 		}
-		if (output.length() > 0) {
-			std::error_code ec = con->send(output);
+
+		// Solo Call, the request takes over the parsed document.
+#ifdef _DEBUG
+		std::string query = input.dump();
+#endif
+		nlohmann::json output = handle_call(handle, info.client.get(), std::move(input), received);
+		if (output.is_object()) {
+			send(handle, info, {prepare_frame(info.codec, output, info.deflate), std::string(), false, 0});
 #ifdef _DEBUG
-			DLOG(LOG_DEBUG, "<%s> Query \"%s\" Reply \"%s\"", con->get_remote_endpoint().c_str(),
-				 msg->get_payload().c_str(), output.c_str());
+			DLOG(LOG_DEBUG, "<%s> Query \"%s\" Reply \"%s\"", con->get_remote_endpoint().c_str(), query.c_str(),
+				 output.dump().c_str());
 		} else {
-			DLOG(LOG_DEBUG, "<%s> Async Query \"%s\"", con->get_remote_endpoint().c_str(), msg->get_payload().c_str());
+			DLOG(LOG_DEBUG, "<%s> Async Query \"%s\"", con->get_remote_endpoint().c_str(), query.c_str());
 #endif
 		}
 	} catch (std::exception const& ex) {
@@ -348,6 +1939,224 @@ void streamdeck::server::ws_on_message(websocketpp::connection_hdl handle, ws_se
 	}
 }
 
+void streamdeck::server::handle_batch(websocketpp::connection_hdl handle, std::shared_ptr<jsonrpc::client> client,
+									  nlohmann::json&& input, std::chrono::steady_clock::time_point received)
+{
+	auto batch       = std::make_shared<batch_state>();
+	batch->handle    = handle;
+	batch->client    = std::move(client);
+	batch->input     = std::move(input);
+	batch->received  = received;
+	batch->responses.resize(batch->input.size());
+
+	// Hold one extra reference until every group is dispatched, so that an empty batch still gets its reply.
+	auto groups        = batch_groups(batch->input);
+	batch->outstanding = groups.size() + 1;
+	for (auto& entries : groups) {
+		auto group     = std::make_shared<batch_group>();
+		group->batch   = batch;
+		group->entries = std::move(entries);
+		group->next    = 0;
+		asio::post(*_batch_pool, std::bind(&streamdeck::server::run_batch_group, this, group, false));
+	}
+	complete_batch(batch);
+}
+
+void streamdeck::server::run_batch_group(std::shared_ptr<batch_group> group, bool on_worker)
+{
+	static const nlohmann::json none;
+	auto const&                 batch = group->batch;
+
+	while (group->next < group->entries.size()) {
+		size_t      idx    = group->entries[group->next];
+		auto const& call   = batch->input.at(idx);
+		auto        method = call.is_object() ? call.find("method") : call.end();
+		auto        found  = call.is_object() ? call.find("params") : call.end();
+		auto const& params = (found != call.end()) ? *found : none;
+		auto        entry  = ((method != call.end()) && method->is_string())
+								 ? _handlers.find(method->get_ref<const std::string&>())
+								 : nullptr;
+		bool        query  = entry && is_query(*entry, params);
+
+		// Synchronous handlers run on the worker like any single call, so that they never run concurrently with each
+		// other. Only queries registered as concurrent, and asynchronous handlers, run on the pool.
+		bool worker = entry && !(query && entry->concurrent)
+					  && !std::holds_alternative<async_handler_callback_t>(entry->handler);
+		if (worker != on_worker) {
+			if (worker) {
+				asio::post(_ws.get_io_service(), std::bind(&streamdeck::server::run_batch_group, this, group, true));
+			} else {
+				asio::post(*_batch_pool, std::bind(&streamdeck::server::run_batch_group, this, group, false));
+			}
+			return;
+		}
+		group->next++;
+
+		// Identical entries always end up in the same group. Queries among them only run once, and later ones take
+		// over the response of the first, until anything else runs that may have changed the outcome.
+		std::string key;
+		if (group->entries.size() > 1) {
+			if (query && call.contains("id")) {
+				// Object keys are kept sorted, so the dump is the same for the same params.
+				key = method->get_ref<const std::string&>() + '\n' + params.dump();
+
+				auto outcome = group->outcomes.find(key);
+				if (outcome != group->outcomes.end()) {
+					entry->metrics->calls++;
+					entry->metrics->shared++;
+					batch->responses[idx]       = outcome->second;
+					batch->responses[idx]["id"] = call.at("id");
+					continue;
+				}
+			} else {
+				group->outcomes.clear();
+			}
+		}
+
+		// Asynchronous handlers get a slot handle, which reply() uses to fill in the response later on.
+		auto slot   = std::make_shared<batch_slot>();
+		slot->batch = batch;
+		slot->index = idx;
+
+		std::weak_ptr<void> slot_handle = slot;
+		{
+			std::unique_lock<std::mutex> lock(_batch_slots_lock);
+			_batch_slots.emplace(slot_handle, slot);
+			_batch_slots_active++;
+			batch->outstanding++;
+		}
+
+		// Each entry belongs to exactly one group, so it can be moved out while other groups run.
+		auto obj = handle_call(slot_handle, batch->client.get(), std::move(batch->input.at(idx)), batch->received);
+		if (obj.is_object()) {
+			if (!key.empty()) {
+				group->outcomes.emplace(std::move(key), obj);
+			}
+
+			// Answered right away, so the slot is no longer needed.
+			batch->responses[idx] = std::move(obj);
+			if (take_batch_slot(slot_handle)) {
+				complete_batch(batch);
+			}
+		}
+	}
+	complete_batch(batch);
+}
+
+void streamdeck::server::complete_batch(const std::shared_ptr<batch_state>& batch)
+{
+	if (--batch->outstanding > 0) {
+		return;
+	}
+
+	nlohmann::json responses = nlohmann::json::array();
+	for (auto& response : batch->responses) {
+		if (response.is_object()) {
+			responses.emplace_back(std::move(response));
+		}
+	}
+
+	outbound_frame frame;
+	frame.broadcast = false;
+	frame.handle    = batch->handle;
+	frame.document  = std::move(responses);
+	enqueue(std::move(frame));
+}
+
+bool streamdeck::server::is_query(const handler_entry& entry, const nlohmann::json& params)
+{
+	// Only plain queries, anything with other params may change state.
+	if (!entry.query_params || !std::holds_alternative<sync_handler_callback_t>(entry.handler)) {
+		return false;
+	}
+	if (params.is_null()) {
+		return true;
+	}
+	if (!params.is_object()) {
+		return false;
+	}
+	for (auto kv = params.begin(); kv != params.end(); ++kv) {
+		if (entry.query_params->count(kv.key()) == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void streamdeck::server::schedule_deadline(std::shared_ptr<call_state> call, std::weak_ptr<void> handle,
+										   std::shared_ptr<streamdeck::jsonrpc::request> req,
+										   std::shared_ptr<method_metrics>               metrics,
+										   std::chrono::steady_clock::time_point         received)
+{
+	auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(call->deadline() - received);
+	auto timer = _ws.set_timer(static_cast<long>(delay.count()), [this, call, handle, req, metrics, received](
+																	 websocketpp::lib::error_code const& ec) {
+		// Only answer if the handler hasn't done so already, and keep it from doing so later.
+		if (ec || !call->finish()) {
+			return;
+		}
+
+		metrics->errors++;
+		metrics->timeouts++;
+		metrics->total.record(std::chrono::steady_clock::now() - received);
+
+		// Already finished above, reply() must not try again.
+		auto res = std::make_shared<streamdeck::jsonrpc::response>();
+		res->copy_id(*req);
+		res->set_call(nullptr);
+		res->set_error(streamdeck::jsonrpc::error_codes::REQUEST_TIMEOUT, "Request timed out.");
+		reply(handle, res);
+	});
+
+	// A reply cancels the timer, which would otherwise keep the call alive for the whole timeout. Timers may only be
+	// touched on the worker.
+	std::weak_ptr<asio::steady_timer> weak = timer;
+	call->set_timer([this, weak]() {
+		asio::post(_ws.get_io_service(), [weak]() {
+			if (auto timer = weak.lock()) {
+				timer->cancel();
+			}
+		});
+	});
+}
+
+void streamdeck::server::drop_batch_slots(const std::weak_ptr<void>& connection)
+{
+	if (_batch_slots_active == 0) {
+		return;
+	}
+
+	// Nobody is left to answer, so the batches are abandoned. Releasing the slots (outside of the lock) expires their
+	// handles, which cancels whatever their handlers still have queued.
+	std::vector<std::shared_ptr<batch_slot>> dropped;
+	{
+		std::unique_lock<std::mutex> lock(_batch_slots_lock);
+		for (auto iter = _batch_slots.begin(); iter != _batch_slots.end();) {
+			auto const& owner = iter->second->batch->handle;
+			if (!owner.owner_before(connection) && !connection.owner_before(owner)) {
+				dropped.push_back(std::move(iter->second));
+				iter = _batch_slots.erase(iter);
+				_batch_slots_active--;
+			} else {
+				++iter;
+			}
+		}
+	}
+}
+
+std::shared_ptr<streamdeck::server::batch_slot> streamdeck::server::take_batch_slot(const std::weak_ptr<void>& handle)
+{
+	std::unique_lock<std::mutex> lock(_batch_slots_lock);
+	auto                         iter = _batch_slots.find(handle);
+	if (iter == _batch_slots.end()) {
+		return nullptr;
+	}
+	auto slot = std::move(iter->second);
+	_batch_slots.erase(iter);
+	_batch_slots_active--;
+	return slot;
+}
+
 std::shared_ptr<streamdeck::server> streamdeck::server::instance()
 {
 	static std::weak_ptr<streamdeck::server> _instance;
@@ -366,8 +2175,11 @@ std::shared_ptr<streamdeck::server> streamdeck::server::instance()
 std::string streamdeck::server::remote_version_string() const
 {
 	std::map<std::string, int> versions;
-	for (auto handle : _ws_clients) {
-		versions[handle.second->get_version()]++;
+	{
+		std::unique_lock<std::mutex> lock(_ws_clients_lock);
+		for (auto const& handle : _ws_clients) {
+			versions[handle.second.client->get_version()]++;
+		}
 	}
 	auto iter = versions.end();
 	std::string result = REMOTE_NOT_CONNECTED;
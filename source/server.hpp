@@ -15,28 +15,111 @@
 
 #pragma once
 #include <atomic>
+#include <chrono>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <string>
 #include <thread>
+#include <variant>
 
 #include <nlohmann/json.hpp>
+#include "call-state.hpp"
+#include "dispatch-table.hpp"
+#include "event-ring.hpp"
 #include "json-rpc.hpp"
+#include "metrics.hpp"
+#include "mpsc-queue.hpp"
+#include "param-schema.hpp"
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable : 4005 4244 4267)
 #endif
 #include <websocketpp/config/asio_no_tls.hpp>
 #include <websocketpp/server.hpp>
+#ifdef ENABLE_PERMESSAGE_DEFLATE
+#include <websocketpp/extensions/permessage_deflate/enabled.hpp>
+#endif
+#include <asio/thread_pool.hpp>
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
 
+#if defined(ASIO_HAS_LOCAL_SOCKETS) && !defined(_WIN32)
+#define HAVE_LOCAL_TRANSPORT
+#endif
+
 namespace streamdeck {
+#ifdef ENABLE_PERMESSAGE_DEFLATE
+	// Default asio configuration with the permessage-deflate extension enabled.
+	struct ws_config : public websocketpp::config::asio {
+		typedef ws_config                 type;
+		typedef websocketpp::config::asio base;
+
+		typedef base::concurrency_type          concurrency_type;
+		typedef base::request_type              request_type;
+		typedef base::response_type             response_type;
+		typedef base::message_type              message_type;
+		typedef base::con_msg_manager_type      con_msg_manager_type;
+		typedef base::endpoint_msg_manager_type endpoint_msg_manager_type;
+		typedef base::alog_type                 alog_type;
+		typedef base::elog_type                 elog_type;
+		typedef base::rng_type                  rng_type;
+
+		struct transport_config : public base::transport_config {
+			typedef type::concurrency_type                               concurrency_type;
+			typedef type::alog_type                                      alog_type;
+			typedef type::elog_type                                      elog_type;
+			typedef type::request_type                                   request_type;
+			typedef type::response_type                                  response_type;
+			typedef websocketpp::transport::asio::basic_socket::endpoint socket_type;
+		};
+		typedef websocketpp::transport::asio::endpoint<transport_config> transport_type;
+
+		struct permessage_deflate_config {};
+		typedef websocketpp::extensions::permessage_deflate::enabled<permessage_deflate_config> permessage_deflate_type;
+	};
+#else
+	typedef websocketpp::config::asio ws_config;
+#endif
+
 	class server {
-		typedef websocketpp::server<websocketpp::config::asio>                                             ws_server_t;
-		typedef std::map<websocketpp::connection_hdl, jsonrpc::client*, std::owner_less<websocketpp::connection_hdl>> ws_clients_t;
+		typedef websocketpp::server<ws_config>                                                             ws_server_t;
+
+		typedef ws_config::con_msg_manager_type           ws_msg_manager_t;
+		typedef websocketpp::processor::hybi13<ws_config> ws_processor_t;
+
+		enum codec_type {
+			JSON,
+			MSGPACK,
+			CBOR,
+			CODEC_COUNT,
+		};
+
+		struct pending_frame {
+			ws_server_t::message_ptr frame;
+			std::string              key;       // Set if a newer frame with the same key may replace it.
+			bool                     droppable; // Notifications may be dropped, replies may not.
+			uint64_t                 overflow;  // Marker for this many dropped notifications, built when sent.
+		};
+
+		struct connection_info {
+			std::shared_ptr<jsonrpc::client> client;
+			codec_type                       codec;         // Negotiated through the WebSocket subprotocol.
+			bool                             shared_frames; // Speaks hybi13 framing, so prepared frames can be shared.
+			bool                             deflate;       // Accepts frames compressed without context takeover.
+			bool                             closing;       // Closed by us, skipped until ws_on_close() untracks it.
+			std::deque<pending_frame>        backlog;       // Frames held back while the client is over its budget.
+
+			std::chrono::steady_clock::time_point last_seen; // Last message or pong received from the client.
+		};
+		typedef std::map<websocketpp::connection_hdl, connection_info, std::owner_less<websocketpp::connection_hdl>>
+			ws_clients_t;
+		typedef std::vector<std::shared_ptr<jsonrpc::client>> client_list_t;
 
 		typedef std::function<std::shared_ptr<streamdeck::jsonrpc::response>(
 			std::shared_ptr<streamdeck::jsonrpc::request>)>
@@ -46,29 +129,218 @@ namespace streamdeck {
 			sync_handler_callback_t;
 		typedef std::function<void(std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>)>
 			async_handler_callback_t;
+		typedef std::variant<handler_callback_t, sync_handler_callback_t, async_handler_callback_t> handler_t;
+		typedef std::function<nlohmann::json()> payload_producer_t;
+
+		struct handler_entry {
+			handler_t                                handler;
+			std::shared_ptr<method_metrics>          metrics;
+			std::optional<std::set<std::string>>     query_params; // Set for handlers whose calls may be shared.
+			std::optional<std::vector<params::info>> params;       // Set for handlers registered with a schema.
+			bool                                     concurrent;   // Queries which may run on the batch pool.
+		};
+
+		// Query a client watches, evaluated again on the worker whenever one of its triggers is notified.
+		struct watch_entry {
+			uint64_t                                      id;
+			websocketpp::connection_hdl                   handle; // Connection that changes are sent to.
+			const sync_handler_callback_t*                callback;
+			const std::vector<std::string>*               triggers;
+			std::shared_ptr<streamdeck::jsonrpc::request> request; // Run again on every evaluation.
+			std::vector<std::string>                      sources; // Triggers referring to other sources are ignored.
+			size_t                                        hash;    // Of the outcome last sent.
+			bool                                          pending; // An evaluation is running or queued.
+			bool                                          dirty;   // Triggered while pending, evaluate once more.
+		};
+
+		struct outbound_frame {
+			bool                        broadcast;
+			websocketpp::connection_hdl handle;
+			std::string                 method;
+			std::string                 key; // Non-empty for notifications that may be merged with newer ones.
+			std::vector<std::string>    sources;
+			nlohmann::json              document; // Encoded on the worker, once for every codec in use.
+		};
+
+		struct coalesced_entry {
+			nlohmann::json           params;
+			std::vector<std::string> sources;
+		};
+		typedef std::map<std::string, std::map<std::string, coalesced_entry>> coalesced_map_t;
+
+		struct batch_state {
+			websocketpp::connection_hdl           handle;
+			std::shared_ptr<jsonrpc::client>      client;
+			nlohmann::json                        input;
+			std::chrono::steady_clock::time_point received;
+			std::vector<nlohmann::json>           responses;   // One per entry, null for entries without a response.
+			std::atomic<size_t>                   outstanding; // Running groups plus asynchronous calls in flight.
+		};
+		struct batch_slot {
+			std::shared_ptr<batch_state> batch;
+			size_t                       index;
+		};
+		typedef std::map<std::weak_ptr<void>, std::shared_ptr<batch_slot>, std::owner_less<std::weak_ptr<void>>>
+			batch_slots_t;
+
+		// Entries of a batch which run in order, moving between the pool and the worker as their handlers require.
+		struct batch_group {
+			std::shared_ptr<batch_state>          batch;
+			std::vector<size_t>                   entries;
+			size_t                                next;     // First entry that hasn't run yet.
+			std::map<std::string, nlohmann::json> outcomes; // Responses of queries, until anything else runs.
+		};
+
+		std::vector<std::function<void()>>        _connection_handlers;
+		streamdeck::dispatch_table<handler_entry> _handlers; // Frozen by start(), read-only afterwards.
+
+		ws_server_t        _ws;
+		ws_clients_t       _ws_clients; // Only modified on the worker thread.
+		mutable std::mutex _ws_clients_lock;
+
+		// Copy of the connected clients for lock-free subscription checks from other threads.
+		std::shared_ptr<const client_list_t> _clients_snapshot;
+
+		// Frames queued by notify() and reply(), drained on the worker thread.
+		streamdeck::mpsc_queue<outbound_frame>    _outbound;
+		std::atomic<bool>                         _outbound_pending;
+		std::unique_ptr<asio::io_service::strand> _outbound_strand;
+
+		// Payloads are framed once on the worker thread, and the buffer is shared by all receiving connections.
+		ws_msg_manager_t::ptr           _frame_manager;
+		ws_config::rng_type             _frame_rng;
+		std::unique_ptr<ws_processor_t> _frame_processor;
+
+		// Payloads at least this large are compressed for clients that negotiated permessage-deflate.
+		size_t                _deflate_threshold;
+		std::atomic<uint64_t> _deflate_messages;
+		std::atomic<uint64_t> _deflate_bytes_in;
+		std::atomic<uint64_t> _deflate_bytes_out;
+		std::atomic<uint64_t> _deflate_time_ns;
+
+		// Per-connection send budget. Past it, frames wait in the connection's backlog instead of websocketpp's buffer.
+		size_t                _backlog_bytes;
+		size_t                _backlog_messages;
+		bool                  _backlog_scheduled; // Only used on the worker thread.
+		std::atomic<uint64_t> _backlog_deferred;
+		std::atomic<uint64_t> _backlog_merged;
+		std::atomic<uint64_t> _backlog_dropped;
+
+		// Latest payload per (method, key) of coalesced notifications, flushed once per window.
+		std::mutex            _coalesce_lock;
+		coalesced_map_t       _coalesced;
+		std::atomic<size_t>   _coalesced_pending;
+		std::atomic<bool>     _coalesce_scheduled;
+		std::atomic<int64_t>  _coalesce_interval; // In milliseconds, 0 flushes on every video tick.
+		std::atomic<uint64_t> _coalesce_received;
+		std::atomic<uint64_t> _coalesce_merged;
+		std::atomic<uint64_t> _coalesce_dropped;
+		std::atomic<uint64_t> _coalesce_sent;
+
+		// Notification payloads handed over as producers, which are only invoked if somebody is listening.
+		std::atomic<uint64_t> _payloads_built;
+		std::atomic<uint64_t> _payloads_skipped;
+		std::atomic<uint64_t> _payloads_discarded; // Built eagerly by the caller, then dropped as nobody listened.
+
+		// Independent entries of batch requests run concurrently on this pool. Asynchronous calls inside a batch get a
+		// slot handle instead of the connection handle, which reply() resolves back to the batch.
+		std::unique_ptr<asio::thread_pool> _batch_pool;
+		std::mutex                         _batch_slots_lock;
+		batch_slots_t                      _batch_slots;
+		std::atomic<size_t>                _batch_slots_active;
+
+		// Watched queries. Triggers are registered along with the handlers and only read afterwards, the watches
+		// themselves come and go with the clients.
+		std::map<std::string, std::vector<std::string>>  _watch_triggers; // Query method to notification methods.
+		mutable std::mutex                               _watches_lock;
+		std::map<uint64_t, std::shared_ptr<watch_entry>> _watches;
+		std::map<std::string, size_t>                    _watched; // Watches per notification method.
+		uint64_t                                         _watch_next;
+		std::atomic<size_t>                              _watches_active;
+		std::atomic<uint64_t>                            _watch_evaluations;
+		std::atomic<uint64_t>                            _watch_changes;
 
-		enum handler_type {
-			DEFAULT,
-			SYNCHRONOUS,
-			ASYNCHRONOUS,
+		// Request metrics, per method in the handler table and for the transport here. Recorded from any thread.
+		streamdeck::latency_histogram _parse_latency;
+		std::atomic<uint64_t>         _messages_received;
+		std::atomic<uint64_t>         _bytes_received;
+		std::atomic<uint64_t>         _messages_sent;
+		std::atomic<uint64_t>         _bytes_sent;
+		std::atomic<uint64_t>         _invalid_calls; // Failed before a handler was found.
+		std::atomic<uint64_t>         _late_replies;  // Dropped, as the call was answered with a timeout already.
+
+		// Broadcast notifications are numbered and the most recent ones kept, so that a client which reconnects can
+		// catch up through obs.session.resume instead of querying everything again.
+		struct history_entry {
+			uint64_t                 sequence;
+			std::string              method;
+			std::vector<std::string> sources;
+			nlohmann::json           document;
+		};
+		struct detached_client {
+			std::shared_ptr<jsonrpc::client>      client;
+			std::chrono::steady_clock::time_point expires;
 		};
 
-		std::vector<std::function<void()>>              _connection_handlers;
-		std::map<std::string, handler_type>             _methods;
-		std::map<std::string, handler_callback_t>       _handler_default;
-		std::map<std::string, sync_handler_callback_t>  _handler_sync;
-		std::map<std::string, async_handler_callback_t> _handler_async;
+		std::string                  _session; // Sequence numbers are only meaningful within the same session.
+		uint64_t                     _sequence;
+		std::mutex                   _history_lock;
+		std::deque<history_entry>    _history;
+		size_t                       _history_limit;
+		uint64_t                     _history_start;  // First sequence number from which on nothing is missing.
+		std::atomic<bool>            _history_gap;    // A notification was dropped as nobody could receive it.
+		uint64_t                     _history_pruned; // Clients that last saw anything older may have missed some.
+		std::chrono::milliseconds    _detach_window;
+		std::vector<detached_client> _detached; // Still count as subscribed for a while, guarded by _ws_clients_lock.
+
+		// Clients quiet for a whole interval are pinged, and closed if the pong doesn't arrive in time. Without this, a
+		// client that vanished without a close frame would keep receiving (and buffering) every broadcast.
+		std::chrono::milliseconds _keepalive_interval; // 0 disables pings.
+		std::chrono::milliseconds _keepalive_timeout;
+		std::atomic<uint64_t>     _keepalive_pings;
+		std::atomic<uint64_t>     _keepalive_reaped;
 
-		ws_server_t  _ws;
-		ws_clients_t _ws_clients;
+#ifdef HAVE_LOCAL_TRANSPORT
+		// Newline delimited JSON-RPC over a local stream socket, for controllers running on the same machine.
+		struct local_session {
+			asio::local::stream_protocol::socket           socket;
+			asio::streambuf                                input;
+			std::deque<std::shared_ptr<const std::string>> output;       // The front entry is being written.
+			size_t                                         output_bytes; // Queued, but not yet written.
+			uint64_t                                       dropped;      // Notifications dropped while over budget.
+			std::shared_ptr<jsonrpc::client>               client;
+
+			local_session(asio::io_service& io, size_t max_message)
+				: socket(io), input(max_message), output(), output_bytes(0), dropped(0),
+				  client(std::make_shared<jsonrpc::client>())
+			{}
+		};
+		typedef std::map<std::weak_ptr<void>, std::shared_ptr<local_session>, std::owner_less<std::weak_ptr<void>>>
+			local_sessions_t;
+
+		bool                                                    _local_enabled;
+		std::unique_ptr<asio::local::stream_protocol::acceptor> _local_acceptor;
+		local_sessions_t                                        _local_sessions; // Only modified on the worker thread.
+		std::string                                             _local_path;
+#endif
+
+#ifdef HAVE_EVENT_RING
+		// Every broadcast notification is mirrored here, if enabled. Only used on the worker thread.
+		size_t                                  _event_ring_size;
+		std::unique_ptr<streamdeck::event_ring> _event_ring;
+#endif
 
 		std::thread       _worker;
 		std::atomic<bool> _worker_alive;
+		std::string       _discovery_file; // Only used on the worker thread.
 
 		public:
 		~server();
 		server();
 
+		// Freeze the registered handlers and start accepting connections. Register everything before calling this.
+		void start();
+
 		// Called when a new connection is made
 		void handle_connect(std::function<void()>);
 
@@ -76,22 +348,195 @@ namespace streamdeck {
 		void handle_sync(std::string method, streamdeck::server::sync_handler_callback_t callback);
 		void handle_async(std::string method, streamdeck::server::async_handler_callback_t callback);
 
+		// Like handle_sync(), for handlers which only read state when called with nothing but the given params.
+		// Identical calls (same method and params) within a batch only run once, and such calls may be watched.
+		// Calls in separate requests are never shared, not even while one of them is still running.
+		// Queries run on the worker like everything else, unless concurrent is set: Then those within a batch run on
+		// the batch pool, alongside the worker and each other. Only set it for handlers which keep no state of their
+		// own and only call into libobs functions that are safe to call from any thread.
+		void handle_query(std::string method, streamdeck::server::sync_handler_callback_t callback,
+						  std::set<std::string> query_params = {}, bool concurrent = false);
+
+		// Like handle_sync(), handle_query() and handle_async(), for methods which declare their params through a
+		// params::method. The params are checked and decoded before the handler is called, and the description is
+		// listed by describe_methods().
+		template<typename T>
+		void handle_sync(const params::method<T>& method, typename params::schema<T>::callback_t callback)
+		{
+			auto const& schema = method.get_schema();
+			_handlers.insert(method.get_name(),
+							 {handler_t(std::in_place_type<sync_handler_callback_t>, schema.bind(std::move(callback))),
+							  std::make_shared<method_metrics>(), std::nullopt, schema.describe()});
+		}
+
+		template<typename T>
+		void handle_query(const params::method<T>& method, typename params::schema<T>::callback_t callback,
+						  std::set<std::string> query_params = {}, bool concurrent = false)
+		{
+			auto const& schema = method.get_schema();
+			_handlers.insert(method.get_name(),
+							 {handler_t(std::in_place_type<sync_handler_callback_t>, schema.bind(std::move(callback))),
+							  std::make_shared<method_metrics>(), std::move(query_params), schema.describe(),
+							  concurrent});
+		}
+
+		template<typename T>
+		void handle_async(const params::method<T>& method, typename params::schema<T>::async_callback_t callback)
+		{
+			auto const& schema = method.get_schema();
+			_handlers.insert(method.get_name(), {handler_t(std::in_place_type<async_handler_callback_t>,
+														   schema.bind_async(std::move(callback))),
+												 std::make_shared<method_metrics>(), std::nullopt, schema.describe()});
+		}
+
+		// Allow clients to watch a method registered through handle_query(). A watch is evaluated again whenever one
+		// of the given notifications is sent, or would have been if anybody was subscribed. Call before start().
+		void set_watch_triggers(std::string method, std::vector<std::string> notifications);
+
+		// Register a watch for the connection behind handle. Returns its id and the current outcome of the query.
+		nlohmann::json watch(std::weak_ptr<void> handle, const std::string& method, const nlohmann::json& params);
+
+		// Remove a watch registered by the connection behind handle. Returns false if there is no such watch.
+		bool unwatch(std::weak_ptr<void> handle, uint64_t id);
+
 		void notify(std::string method, nlohmann::json params = nlohmann::json());
 
+		// Like notify(), but only the latest params for each (method, key) pair within the coalescing window are sent.
+		// Use for high-frequency state updates where intermediate values are irrelevant.
+		void notify_coalesced(std::string method, std::string key, nlohmann::json params);
+
+		// Lazy variants of the above. The producer runs on the calling thread, and only if at least one client is
+		// subscribed to the method, so idle notifications don't allocate any JSON at all.
+		void notify(std::string method, payload_producer_t producer);
+		void notify_coalesced(std::string method, std::string key, payload_producer_t producer);
+
+		void                      set_coalesce_interval(std::chrono::milliseconds interval);
+		std::chrono::milliseconds get_coalesce_interval() const;
+
+		struct coalesce_stats {
+			uint64_t received; // Calls to notify_coalesced().
+			uint64_t merged;   // Replaced a pending payload for the same key.
+			uint64_t dropped;  // Discarded as no client was subscribed.
+			uint64_t sent;     // Flushed to the clients.
+		};
+		coalesce_stats get_coalesce_stats() const;
+
+		struct deflate_stats {
+			uint64_t messages;  // Frames compressed with permessage-deflate.
+			uint64_t bytes_in;  // Payload size before compression.
+			uint64_t bytes_out; // Payload size after compression.
+			uint64_t time_ns;   // Time spent compressing.
+		};
+		deflate_stats get_deflate_stats() const;
+
+		struct backlog_stats {
+			uint64_t deferred; // Frames held back because a client was over its send budget.
+			uint64_t merged;   // Replaced by a newer frame with the same key while held back.
+			uint64_t dropped;  // Discarded because a client's backlog was full.
+		};
+		backlog_stats get_backlog_stats() const;
+
+		// Latency histograms per method and transport counters, along with the statistics above.
+		nlohmann::json get_metrics() const;
+
+		// Every registered method, along with the params of those registered with a schema.
+		nlohmann::json describe_methods() const;
+
+		// Notifications the client would have received after the given sequence number, or a request to resync.
+		nlohmann::json resume(const jsonrpc::client& client, const std::string& session, uint64_t sequence);
+
+		// Check if any connected client wants to receive the given notification.
+		bool is_subscribed(const std::string& method, const std::vector<std::string>& sources) const;
+
 		void reply(std::weak_ptr<void> handle, std::shared_ptr<streamdeck::jsonrpc::response> response);
 
 		std::string remote_version_string() const;
 
 		private:
 		void run();
+		void shutdown();
+
+		void write_discovery_file(const std::string& address, unsigned short port);
+		void remove_discovery_file();
+
+		// Like is_subscribed(), for notifications which are dropped if this returns false. Notes a gap in the history
+		// if nobody at all could have received them.
+		bool is_deliverable(const std::string& method, const std::vector<std::string>& sources);
+
+		void update_clients_snapshot();
+		void detach_client(std::shared_ptr<jsonrpc::client> client);
+		void prune_detached();
+		void mark_pruned();
+
+		void schedule_keepalive();
+		void keepalive();
+
+		bool                        is_watched(const std::string& method) const;
+		void                        trigger_watches(const std::string& method, const nlohmann::json& params);
+		void                        evaluate_watch(std::shared_ptr<watch_entry> watch);
+		nlohmann::json              run_watch(const watch_entry& watch);
+		bool                        finish_watch(const std::shared_ptr<watch_entry>& watch, size_t hash);
+		void                        release_watch(const watch_entry& watch); // Call with _watches_lock held.
+		void                        remove_watches(const std::weak_ptr<void>& handle);
+		websocketpp::connection_hdl connection_of(const std::weak_ptr<void>& handle);
+
+#ifdef HAVE_LOCAL_TRANSPORT
+		void local_start();
+		void local_stop();
+		void local_accept();
+		void local_read(std::shared_ptr<local_session> session);
+		void local_on_message(const std::shared_ptr<local_session>& session, const std::string& payload);
+		void local_send(const std::shared_ptr<local_session>& session, std::shared_ptr<const std::string> payload,
+						bool droppable);
+		void local_write(std::shared_ptr<local_session> session);
+		void local_close(const std::shared_ptr<local_session>& session);
+#endif
+
+		void enqueue_notification(std::string method, std::string key, std::vector<std::string> sources,
+								  nlohmann::json params);
+		void enqueue(outbound_frame&& frame);
+		void schedule_coalesced();
+		void flush_coalesced(const std::string* method = nullptr);
+		static void on_video_tick(void* ptr, float seconds);
+		void flush_outbound();
+		static bool           parse_subprotocol(const std::string& name, codec_type& codec);
+		static nlohmann::json decode(codec_type codec, const std::string& payload);
+		static std::string    encode(codec_type codec, const nlohmann::json& document);
+
+		ws_server_t::message_ptr prepare_frame(codec_type codec, const nlohmann::json& document, bool deflate);
+		void send(websocketpp::connection_hdl handle, connection_info& info, pending_frame&& frame);
+		bool try_send(websocketpp::connection_hdl handle, const connection_info& info,
+					  const ws_server_t::message_ptr& frame);
+		bool flush_backlog(websocketpp::connection_hdl handle, connection_info& info);
+		void flush_backlogs();
+
+		nlohmann::json handle_call(websocketpp::connection_hdl handle, jsonrpc::client* client,
+								   nlohmann::json&& request, std::chrono::steady_clock::time_point received);
+
+		void                        handle_batch(websocketpp::connection_hdl           handle,
+												 std::shared_ptr<jsonrpc::client>      client, nlohmann::json&& input,
+												 std::chrono::steady_clock::time_point received);
+		void                        run_batch_group(std::shared_ptr<batch_group> group, bool on_worker);
+		void                        complete_batch(const std::shared_ptr<batch_state>& batch);
+		std::shared_ptr<batch_slot> take_batch_slot(const std::weak_ptr<void>& handle);
+		void                        drop_batch_slots(const std::weak_ptr<void>& connection);
+
+		// Whether a call with these params only reads state, so that its outcome may be shared.
+		static bool is_query(const handler_entry& entry, const nlohmann::json& params);
 
-		nlohmann::json handle_call(websocketpp::connection_hdl handle, nlohmann::json& request);
+		// Answer an asynchronous call with a timeout error, unless its handler replies in time.
+		void schedule_deadline(std::shared_ptr<call_state> call, std::weak_ptr<void> handle,
+							   std::shared_ptr<streamdeck::jsonrpc::request> req,
+							   std::shared_ptr<method_metrics>               metrics,
+							   std::chrono::steady_clock::time_point         received);
 
 		private /* WebSocket Callbacks */:
 		bool ws_on_validate(websocketpp::connection_hdl);
 		void ws_on_open(websocketpp::connection_hdl);
 		void ws_on_message(websocketpp::connection_hdl, ws_server_t::message_ptr);
 		void ws_on_close(websocketpp::connection_hdl);
+		void ws_on_pong(websocketpp::connection_hdl, std::string);
+		void ws_on_pong_timeout(websocketpp::connection_hdl, std::string);
 
 		public /* Singleton */:
 		static std::shared_ptr<streamdeck::server> instance();
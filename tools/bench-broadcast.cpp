@@ -0,0 +1,151 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Broadcasting a ~50 kB notification to 8 clients, through the real server on loopback.
+//
+// Each notification goes through notify(), flush_outbound() and prepare_frame(), and is framed once per codec in use.
+// The time is from calling notify() until the last client received it. The bytes sent are read from the server's
+// transport metrics.
+
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "server-harness.hpp"
+
+#define CLIENTS 8
+#define PAYLOAD_SIZE 50000
+#define ROUNDS 500
+
+static nlohmann::json build_params(int64_t round)
+{
+	// Shaped like an obs.source.event.create notification for a large scene collection.
+	nlohmann::json sources = nlohmann::json::array();
+	for (size_t idx = 0; sources.dump().size() < PAYLOAD_SIZE; idx++) {
+		nlohmann::json source;
+		source["name"]           = "Source " + std::to_string(idx) + " \xC3\xA4";
+		source["id"]             = "ffmpeg_source";
+		source["id_unversioned"] = "ffmpeg_source";
+		source["type"]           = "input";
+		source["output_flags"]   = {"video", "audio", "async", "controllable_media"};
+		source["enabled"]        = true;
+		source["active"]         = (idx % 2) == 0;
+		source["muted"]          = false;
+		source["volume"]         = 1.0;
+		source["balance"]        = 0.5;
+		sources.push_back(std::move(source));
+	}
+	return {{"round", round}, {"sources", std::move(sources)}};
+}
+
+// Counts the clients which received the notification of the current round.
+struct receipts {
+	std::mutex              lock;
+	std::condition_variable signal;
+	int64_t                 round    = -1;
+	size_t                  received = 0;
+
+	void on_notification(const nlohmann::json& document)
+	{
+		if (document.value("method", std::string()) != "bench.broadcast") {
+			return;
+		}
+		std::unique_lock<std::mutex> guard(lock);
+		if (document["params"].value("round", int64_t(-1)) == round) {
+			received++;
+			signal.notify_all();
+		}
+	}
+};
+
+static bool bench(streamdeck::server& server, const std::string& token, const char* name, size_t msgpack_clients)
+{
+	receipts                                                   state;
+	std::vector<std::unique_ptr<streamdeck::tools::ws_client>> clients;
+	unsigned short                                             port = 0;
+	for (size_t idx = 0; idx < CLIENTS; idx++) {
+		auto client = std::make_unique<streamdeck::tools::ws_client>(
+			(idx < msgpack_clients) ? "streamdeck-obs+msgpack" : "streamdeck-obs",
+			[&state](const nlohmann::json& document) { state.on_notification(document); });
+
+		// The reply to the identification also means that the server has seen the connection open.
+		if (port == 0) {
+			port = streamdeck::tools::connect_to_server(*client, token);
+		} else if (!client->connect(port) || !client->call("bench.identify").is_object()) {
+			port = 0;
+		}
+		if (port == 0) {
+			std::fprintf(stderr, "Failed to connect to the server.\n");
+			return false;
+		}
+		clients.push_back(std::move(client));
+	}
+
+	std::vector<nlohmann::json> params;
+	for (int64_t round = 0; round < ROUNDS; round++) {
+		params.push_back(build_params(round));
+	}
+	auto bytes_before = server.get_metrics()["transport"]["bytes_sent"].get<uint64_t>();
+
+	std::vector<double> latencies;
+	for (int64_t round = 0; round < ROUNDS; round++) {
+		{
+			std::unique_lock<std::mutex> guard(state.lock);
+			state.round    = round;
+			state.received = 0;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		server.notify("bench.broadcast", std::move(params[round]));
+		std::unique_lock<std::mutex> guard(state.lock);
+		if (!state.signal.wait_for(guard, std::chrono::seconds(5), [&state]() { return state.received == CLIENTS; })) {
+			std::fprintf(stderr, "%s: Only %zu clients received round %" PRId64 ".\n", name, state.received, round);
+			return false;
+		}
+		latencies.push_back(
+			std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+	}
+
+	auto bytes_after = server.get_metrics()["transport"]["bytes_sent"].get<uint64_t>();
+	streamdeck::tools::print_latencies(name, std::move(latencies));
+	std::printf("%-24s %" PRIu64 " bytes sent per broadcast\n", "", (bytes_after - bytes_before) / ROUNDS);
+
+	for (auto& client : clients) {
+		client->close();
+	}
+	return true;
+}
+
+int main()
+{
+	streamdeck::tools::obs_scope obs;
+	{
+		auto server = streamdeck::server::instance();
+		auto token  = streamdeck::tools::register_identity(*server);
+		server->start();
+
+		std::printf("%d clients, %d broadcasts of %zu bytes\n", CLIENTS, ROUNDS, build_params(0).dump().size());
+		if (!bench(*server, token, "json", 0) || !bench(*server, token, "json and msgpack", CLIENTS / 2)) {
+			return 1;
+		}
+	}
+	return 0;
+}
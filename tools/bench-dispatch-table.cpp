@@ -0,0 +1,78 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Method lookup over the names the handlers register.
+//
+// "two maps" is the old handle_call(), which looked the method up in _methods and then again in the map for its kind of
+// handler. "dispatch_table" is the single lookup it does now. std::unordered_map is listed for reference.
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "check.hpp"
+#include "dispatch-table.hpp"
+#include "method-names.hpp"
+
+#define ROUNDS 20000
+
+int main()
+{
+	std::vector<std::string> calls;
+	for (size_t idx = 0; idx < streamdeck::tools::method_count; idx++) {
+		calls.push_back(streamdeck::tools::method_names[idx]);
+	}
+	calls.push_back("obs.unknown.method");
+
+	std::map<std::string, int>           methods;
+	std::map<std::string, int>           handlers;
+	std::unordered_map<std::string, int> hashed;
+	streamdeck::dispatch_table<int>      table;
+	for (size_t idx = 0; idx < streamdeck::tools::method_count; idx++) {
+		methods.emplace(streamdeck::tools::method_names[idx], int(idx % 3));
+		handlers.emplace(streamdeck::tools::method_names[idx], int(idx));
+		hashed.emplace(streamdeck::tools::method_names[idx], int(idx));
+		table.insert(streamdeck::tools::method_names[idx], int(idx));
+	}
+	table.freeze();
+
+	size_t found = 0;
+
+	double maps = streamdeck::tools::time_per_iteration(ROUNDS, [&]() {
+		for (auto const& call : calls) {
+			if (methods.find(call) != methods.end()) {
+				found += handlers.find(call) != handlers.end();
+			}
+		}
+	});
+	double unordered = streamdeck::tools::time_per_iteration(ROUNDS, [&]() {
+		for (auto const& call : calls) {
+			found += hashed.find(call) != hashed.end();
+		}
+	});
+	double frozen = streamdeck::tools::time_per_iteration(ROUNDS, [&]() {
+		for (auto const& call : calls) {
+			found += table.find(call) != nullptr;
+		}
+	});
+
+	double lookups = double(calls.size());
+	std::printf("%zu methods, plus one unknown\n", streamdeck::tools::method_count);
+	std::printf("two maps           %6.1f ns/lookup\n", maps / lookups);
+	std::printf("std::unordered_map %6.1f ns/lookup\n", unordered / lookups);
+	std::printf("dispatch_table     %6.1f ns/lookup\n", frozen / lookups);
+	return found == 0;
+}
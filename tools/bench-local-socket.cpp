@@ -0,0 +1,258 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Round trip of a small call over the local socket, against the WebSocket path on TCP loopback.
+//
+// "websocket" sends a masked client frame over TCP with Nagle disabled, and the server unmasks it and answers with an
+// unmasked frame, as websocketpp does. "local" sends newline terminated messages over an AF_UNIX stream socket, as
+// the local socket transport does. The handshakes are done before measuring, and no JSON is parsed on either side, so
+// only the transport and framing differ.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define ROUND_TRIPS 20000
+
+static const char* request = R"({"jsonrpc":"2.0","id":1,"method":"obs.frontend.streaming.active"})";
+static const char* reply   = R"({"jsonrpc":"2.0","id":1,"result":false})";
+
+static bool write_all(int fd, const std::string& data)
+{
+	size_t offset = 0;
+	while (offset < data.size()) {
+		ssize_t written = ::send(fd, data.data() + offset, data.size() - offset, 0);
+		if (written <= 0) {
+			return false;
+		}
+		offset += size_t(written);
+	}
+	return true;
+}
+
+static bool read_exact(int fd, uint8_t* data, size_t size)
+{
+	size_t offset = 0;
+	while (offset < size) {
+		ssize_t read = ::recv(fd, data + offset, size - offset, 0);
+		if (read <= 0) {
+			return false;
+		}
+		offset += size_t(read);
+	}
+	return true;
+}
+
+/* WebSocket framing, for payloads below 126 bytes. */
+
+static std::string ws_frame(const std::string& payload, bool masked)
+{
+	std::string frame;
+	frame.push_back(char(0x81));
+	frame.push_back(char((masked ? 0x80 : 0x00) | payload.size()));
+	if (!masked) {
+		return frame + payload;
+	}
+
+	const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+	frame.append(reinterpret_cast<const char*>(mask), 4);
+	for (size_t idx = 0; idx < payload.size(); idx++) {
+		frame.push_back(char(uint8_t(payload[idx]) ^ mask[idx % 4]));
+	}
+	return frame;
+}
+
+static bool ws_read(int fd, std::string& payload)
+{
+	uint8_t header[2];
+	if (!read_exact(fd, header, 2)) {
+		return false;
+	}
+	size_t  size = header[1] & 0x7F;
+	uint8_t mask[4] = {0, 0, 0, 0};
+	if ((header[1] & 0x80) && !read_exact(fd, mask, 4)) {
+		return false;
+	}
+	payload.resize(size);
+	if (!read_exact(fd, reinterpret_cast<uint8_t*>(&payload[0]), size)) {
+		return false;
+	}
+	for (size_t idx = 0; idx < size; idx++) {
+		payload[idx] = char(uint8_t(payload[idx]) ^ mask[idx % 4]);
+	}
+	return true;
+}
+
+/* Newline framing, as read by async_read_until(). */
+
+class line_reader {
+	int         _fd;
+	std::string _buffer;
+
+	public:
+	line_reader(int fd) : _fd(fd), _buffer() {}
+
+	bool read(std::string& line)
+	{
+		size_t end;
+		while ((end = _buffer.find('\n')) == std::string::npos) {
+			char    chunk[4096];
+			ssize_t read = ::recv(_fd, chunk, sizeof(chunk), 0);
+			if (read <= 0) {
+				return false;
+			}
+			_buffer.append(chunk, size_t(read));
+		}
+		line = _buffer.substr(0, end);
+		_buffer.erase(0, end + 1);
+		return true;
+	}
+};
+
+static void report(const char* name, std::vector<double>& values)
+{
+	std::sort(values.begin(), values.end());
+	auto at = [&values](double percentile) { return values[size_t(percentile * double(values.size() - 1))]; };
+	std::printf("%-9s round trips=%zu p50=%.1fus p90=%.1fus p99=%.1fus\n", name, values.size(), at(0.5), at(0.9),
+				at(0.99));
+}
+
+template<typename F>
+static std::vector<double> measure(F&& round_trip)
+{
+	std::vector<double> values;
+	values.reserve(ROUND_TRIPS);
+	for (size_t idx = 0; idx < ROUND_TRIPS; idx++) {
+		auto start = std::chrono::steady_clock::now();
+		if (!round_trip()) {
+			std::fprintf(stderr, "Round trip failed.\n");
+			std::exit(EXIT_FAILURE);
+		}
+		values.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+	}
+	return values;
+}
+
+static void bench_websocket()
+{
+	int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+	int enable   = 1;
+
+	sockaddr_in address{};
+	address.sin_family      = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	address.sin_port        = 0;
+	socklen_t length        = sizeof(address);
+	if ((::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+		|| (::listen(listener, 1) != 0)
+		|| (::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length) != 0)) {
+		std::perror("TCP listen");
+		std::exit(EXIT_FAILURE);
+	}
+
+	std::thread server([listener, enable]() {
+		int fd = ::accept(listener, nullptr, nullptr);
+		::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+		std::string payload;
+		std::string answer = ws_frame(reply, false);
+		while (ws_read(fd, payload) && write_all(fd, answer)) {
+		}
+		::close(fd);
+	});
+
+	int client = ::socket(AF_INET, SOCK_STREAM, 0);
+	::setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+	if (::connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+		std::perror("TCP connect");
+		std::exit(EXIT_FAILURE);
+	}
+
+	std::string frame = ws_frame(request, true);
+	std::string payload;
+	auto        values = measure([&]() { return write_all(client, frame) && ws_read(client, payload); });
+
+	::close(client);
+	server.join();
+	::close(listener);
+	report("websocket", values);
+}
+
+static void bench_local()
+{
+	char directory[] = "/tmp/streamdeck-bench-XXXXXX";
+	if (!::mkdtemp(directory)) {
+		std::perror("mkdtemp");
+		std::exit(EXIT_FAILURE);
+	}
+	std::string path = std::string(directory) + "/rpc.sock";
+
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+	int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if ((::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+		|| (::listen(listener, 1) != 0)) {
+		std::perror("AF_UNIX listen");
+		std::exit(EXIT_FAILURE);
+	}
+
+	std::thread server([listener]() {
+		int         fd = ::accept(listener, nullptr, nullptr);
+		line_reader reader(fd);
+		std::string line;
+		std::string answer = std::string(reply) + "\n";
+		while (reader.read(line) && write_all(fd, answer)) {
+		}
+		::close(fd);
+	});
+
+	int client = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (::connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+		std::perror("AF_UNIX connect");
+		std::exit(EXIT_FAILURE);
+	}
+
+	std::string message = std::string(request) + "\n";
+	std::string line;
+	line_reader reader(client);
+	auto        values = measure([&]() { return write_all(client, message) && reader.read(line); });
+
+	::close(client);
+	server.join();
+	::close(listener);
+	::unlink(path.c_str());
+	::rmdir(directory);
+	report("local", values);
+}
+
+int main()
+{
+	bench_websocket();
+	bench_local();
+	return 0;
+}
@@ -0,0 +1,112 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Time from sending a request to receiving its reply, through the real server on loopback.
+//
+// "idle" waits a random time of up to 2 ms between requests, like key presses would, so that the worker has to wake
+// up for every one of them. "back-to-back" sends the next request as soon as the reply arrived. "sync" is answered
+// on the worker, "async" from another thread through server::reply(), as handlers queueing an OBS task are.
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include "server-harness.hpp"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4005 4244 4267)
+#endif
+#include <asio/post.hpp>
+#include <asio/thread_pool.hpp>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#define REQUESTS 2000
+
+static bool bench(streamdeck::tools::ws_client& client, const char* name, const std::string& method, bool idle)
+{
+	std::mt19937                       rng(42);
+	std::uniform_int_distribution<int> gap(0, 2000);
+	std::vector<double>                latencies;
+	latencies.reserve(REQUESTS);
+
+	for (int64_t idx = 0; idx < REQUESTS; idx++) {
+		if (idle) {
+			std::this_thread::sleep_for(std::chrono::microseconds(gap(rng)));
+		}
+
+		auto start    = std::chrono::steady_clock::now();
+		auto response = client.call(method, {{"value", idx}});
+		auto elapsed  = std::chrono::steady_clock::now() - start;
+		if (!response.is_object() || (response.value("result", nlohmann::json()) != idx)) {
+			std::fprintf(stderr, "%s: Unexpected reply %s\n", name, response.dump().c_str());
+			return false;
+		}
+		latencies.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+	}
+
+	streamdeck::tools::print_latencies(name, std::move(latencies));
+	return true;
+}
+
+int main()
+{
+	streamdeck::tools::obs_scope obs;
+	asio::thread_pool            tasks(1); // Stands in for the OBS task queues asynchronous handlers reply from.
+
+	{
+		auto server = streamdeck::server::instance();
+		auto token  = streamdeck::tools::register_identity(*server);
+		server->handle_sync("bench.sync", [](std::shared_ptr<streamdeck::jsonrpc::request>  req,
+											 std::shared_ptr<streamdeck::jsonrpc::response> res) {
+			res->set_result(req->get_params().at("value"));
+		});
+		// A plain pointer, as the server would otherwise keep itself alive through its own handler.
+		auto self = server.get();
+		server->handle_async("bench.async", [&tasks, self](std::weak_ptr<void>                           handle,
+															std::shared_ptr<streamdeck::jsonrpc::request> req) {
+			asio::post(tasks, [self, handle, req]() {
+				auto res = std::make_shared<streamdeck::jsonrpc::response>();
+				res->copy_id(*req);
+				res->set_result(req->get_params().at("value"));
+				self->reply(handle, res);
+			});
+		});
+		server->start();
+
+		streamdeck::tools::ws_client client;
+		auto                         port = streamdeck::tools::connect_to_server(client, token);
+		if (port == 0) {
+			std::fprintf(stderr, "Failed to connect to the server.\n");
+			return 1;
+		}
+		std::printf("server on port %u, %d requests each\n", unsigned(port), REQUESTS);
+
+		bool ok = bench(client, "sync, idle", "bench.sync", true)
+				  && bench(client, "sync, back-to-back", "bench.sync", false)
+				  && bench(client, "async, idle", "bench.async", true)
+				  && bench(client, "async, back-to-back", "bench.async", false);
+		client.close();
+		tasks.join();
+		if (!ok) {
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,138 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "check.hpp"
+#include "dispatch-table.hpp"
+#include "method-names.hpp"
+
+static void check_lookup()
+{
+	streamdeck::dispatch_table<size_t> table;
+	for (size_t idx = 0; idx < streamdeck::tools::method_count; idx++) {
+		CHECK(table.insert(streamdeck::tools::method_names[idx], idx));
+	}
+	CHECK(table.size() == streamdeck::tools::method_count);
+
+	// Nothing can be found until the table is frozen.
+	CHECK(table.find("ping") == nullptr);
+	CHECK(!table.frozen());
+	table.freeze();
+	CHECK(table.frozen());
+
+	for (size_t idx = 0; idx < streamdeck::tools::method_count; idx++) {
+		auto value = table.find(streamdeck::tools::method_names[idx]);
+		CHECK(value && (*value == idx));
+	}
+	CHECK(table.find("") == nullptr);
+	CHECK(table.find("obs.source") == nullptr);
+	CHECK(table.find("obs.source.state ") == nullptr);
+	CHECK(table.find("OBS.SOURCE.STATE") == nullptr);
+
+	// Freezing again changes nothing, inserting afterwards is a mistake.
+	table.freeze();
+	CHECK(table.find("ping") != nullptr);
+	CHECK_THROWS(table.insert("late", 0), std::logic_error);
+}
+
+static void check_duplicates()
+{
+	streamdeck::dispatch_table<int> table;
+	CHECK(table.insert("ping", 1));
+	CHECK(!table.insert("ping", 2));
+	CHECK(table.size() == 1);
+	table.freeze();
+
+	auto value = table.find("ping");
+	CHECK(value && (*value == 1));
+
+	std::vector<std::string> keys;
+	table.for_each([&keys](const std::string& key, int) { keys.push_back(key); });
+	CHECK((keys.size() == 1) && (keys[0] == "ping"));
+}
+
+static void check_empty()
+{
+	streamdeck::dispatch_table<int> table;
+	table.freeze();
+	CHECK(table.size() == 0);
+	CHECK(table.find("ping") == nullptr);
+}
+
+static void check_order()
+{
+	streamdeck::dispatch_table<size_t> table;
+	for (size_t idx = 0; idx < streamdeck::tools::method_count; idx++) {
+		table.insert(streamdeck::tools::method_names[idx], idx);
+	}
+
+	size_t expected = 0;
+	bool   ordered  = true;
+	table.for_each([&](const std::string& key, size_t value) {
+		ordered = ordered && (value == expected) && (key == streamdeck::tools::method_names[expected]);
+		expected++;
+	});
+	CHECK(ordered);
+	CHECK(expected == streamdeck::tools::method_count);
+}
+
+static void check_readers()
+{
+	// Readers on other threads only see the table once it is complete.
+	streamdeck::dispatch_table<size_t> table;
+	std::atomic<bool>                  consistent{true};
+	std::vector<std::thread>           readers;
+	for (size_t reader = 0; reader < 4; reader++) {
+		readers.emplace_back([&table, &consistent]() {
+			while (!table.frozen()) {
+				if (table.find("ping") != nullptr) {
+					consistent = false;
+				}
+				std::this_thread::yield();
+			}
+			for (size_t round = 0; round < 1000; round++) {
+				for (size_t idx = 0; idx < streamdeck::tools::method_count; idx++) {
+					auto value = table.find(streamdeck::tools::method_names[idx]);
+					if (!value || (*value != idx)) {
+						consistent = false;
+					}
+				}
+			}
+		});
+	}
+
+	for (size_t idx = 0; idx < streamdeck::tools::method_count; idx++) {
+		table.insert(streamdeck::tools::method_names[idx], idx);
+	}
+	table.freeze();
+	for (auto& thread : readers) {
+		thread.join();
+	}
+	CHECK(consistent);
+}
+
+int main()
+{
+	check_lookup();
+	check_duplicates();
+	check_empty();
+	check_order();
+	check_readers();
+	return streamdeck::tools::check_result();
+}
@@ -0,0 +1,176 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "check.hpp"
+#include "metrics.hpp"
+
+static void check_empty()
+{
+	streamdeck::latency_histogram histogram;
+	auto                          result = histogram.to_json();
+	CHECK(histogram.count() == 0);
+	CHECK(result["count"] == 0);
+	CHECK(result["mean"] == 0.0);
+	CHECK(result["max"] == 0);
+	CHECK(result["p50"] == 0);
+	CHECK(result["p999"] == 0);
+}
+
+static void check_precision()
+{
+	// Small values are exact, everything else is reported at most 12.5% too high, and never too low.
+	bool exact   = true;
+	bool precise = true;
+	for (uint64_t value = 0; value < 200000; value += (value < 1000) ? 1 : 97) {
+		streamdeck::latency_histogram histogram;
+		histogram.record(value);
+		uint64_t reported = histogram.to_json()["p50"];
+		if ((value < 8) && (reported != value)) {
+			exact = false;
+		}
+		if ((reported < value) || ((reported - value) > (value / 8))) {
+			precise = false;
+		}
+	}
+	CHECK(exact);
+	CHECK(precise);
+}
+
+static void check_clamp()
+{
+	// Anything beyond ~134 seconds lands in the last bucket, but the maximum is kept as is.
+	streamdeck::latency_histogram histogram;
+	histogram.record(uint64_t(1) << 40);
+	auto result = histogram.to_json();
+	CHECK(result["max"] == (uint64_t(1) << 40));
+	CHECK(result["p50"] == ((uint64_t(1) << 27) - 1));
+}
+
+static void check_percentiles()
+{
+	streamdeck::latency_histogram histogram;
+	for (uint64_t value = 1; value <= 1000; value++) {
+		histogram.record(value);
+	}
+
+	auto result = histogram.to_json();
+	CHECK(result["count"] == 1000);
+	CHECK(result["mean"] == 500.5);
+	CHECK(result["max"] == 1000);
+
+	uint64_t p50 = result["p50"];
+	uint64_t p90 = result["p90"];
+	uint64_t p99 = result["p99"];
+	CHECK((p50 >= 500) && (p50 <= 500 + 500 / 8));
+	CHECK((p90 >= 900) && (p90 <= 900 + 900 / 8));
+	CHECK((p99 >= 990) && (p99 <= 990 + 990 / 8));
+	CHECK((p50 <= p90) && (p90 <= p99) && (p99 <= result["p999"]));
+}
+
+static void check_durations()
+{
+	streamdeck::latency_histogram histogram;
+	histogram.record(std::chrono::microseconds(1500));
+	histogram.record(std::chrono::nanoseconds(999));
+	histogram.record(std::chrono::steady_clock::duration(-5)); // Clocks aren't always kind, must not wrap around.
+
+	auto result = histogram.to_json();
+	CHECK(result["count"] == 3);
+	CHECK(result["max"] == 1500);
+	CHECK(result["p50"] == 0);
+}
+
+static void check_threads()
+{
+	streamdeck::latency_histogram histogram;
+	std::vector<std::thread>      threads;
+	for (uint64_t thread = 0; thread < 4; thread++) {
+		threads.emplace_back([&histogram, thread]() {
+			for (uint64_t value = 0; value < 100000; value++) {
+				histogram.record((value % 1000) + thread);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	auto result = histogram.to_json();
+	CHECK(histogram.count() == 400000);
+	CHECK(result["count"] == 400000);
+	CHECK(result["max"] == 1002);
+}
+
+static void check_method_metrics()
+{
+	streamdeck::method_metrics metrics;
+	metrics.calls++;
+	metrics.dispatch.record(10);
+	metrics.total.record(20);
+
+	// Queue and execution times are only listed for methods which queue tasks.
+	auto result = metrics.to_json();
+	CHECK(result["calls"] == 1);
+	CHECK(result["dispatch"]["count"] == 1);
+	CHECK(result["total"]["max"] == 20);
+	CHECK(!result.contains("queue"));
+	CHECK(!result.contains("execute"));
+
+	metrics.queue.record(5);
+	metrics.execute.record(7);
+	result = metrics.to_json();
+	CHECK(result["queue"]["max"] == 5);
+	CHECK(result["execute"]["max"] == 7);
+}
+
+static void check_scope()
+{
+	CHECK(streamdeck::metrics_scope::current() == nullptr);
+	auto outer_metrics = std::make_shared<streamdeck::method_metrics>();
+	auto inner_metrics = std::make_shared<streamdeck::method_metrics>();
+	{
+		streamdeck::metrics_scope outer(outer_metrics, std::chrono::steady_clock::now());
+		CHECK(streamdeck::metrics_scope::current() == &outer);
+		{
+			streamdeck::metrics_scope inner(inner_metrics, std::chrono::steady_clock::now());
+			CHECK(streamdeck::metrics_scope::current()->metrics() == inner_metrics);
+		}
+		CHECK(streamdeck::metrics_scope::current() == &outer);
+
+		// Scopes are per thread.
+		const streamdeck::metrics_scope* other = &outer;
+		std::thread([&other]() { other = streamdeck::metrics_scope::current(); }).join();
+		CHECK(other == nullptr);
+	}
+	CHECK(streamdeck::metrics_scope::current() == nullptr);
+}
+
+int main()
+{
+	check_empty();
+	check_precision();
+	check_clamp();
+	check_percentiles();
+	check_durations();
+	check_threads();
+	check_method_metrics();
+	check_scope();
+	return streamdeck::tools::check_result();
+}
@@ -0,0 +1,119 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "check.hpp"
+#include "mpsc-queue.hpp"
+
+#define PRODUCERS 4
+#define PER_PRODUCER 100000
+
+static void check_order()
+{
+	streamdeck::mpsc_queue<int> queue;
+	int                         value = -1;
+
+	CHECK(!queue.pop(value));
+	for (int idx = 0; idx < 10; idx++) {
+		queue.push(int(idx));
+	}
+	for (int idx = 0; idx < 10; idx++) {
+		CHECK(queue.pop(value));
+		CHECK(value == idx);
+	}
+	CHECK(!queue.pop(value));
+
+	// Empty again, and still usable afterwards.
+	queue.push(42);
+	CHECK(queue.pop(value));
+	CHECK(value == 42);
+}
+
+static void check_ownership()
+{
+	auto tracker = std::make_shared<int>(0);
+	{
+		streamdeck::mpsc_queue<std::shared_ptr<int>> queue;
+		queue.push(std::shared_ptr<int>(tracker));
+		queue.push(std::shared_ptr<int>(tracker));
+
+		std::shared_ptr<int> value;
+		CHECK(queue.pop(value));
+		CHECK(value == tracker);
+		value.reset();
+		CHECK(tracker.use_count() == 2);
+	}
+	// Whatever was left in the queue is released along with it.
+	CHECK(tracker.use_count() == 1);
+
+	streamdeck::mpsc_queue<std::unique_ptr<int>> queue;
+	queue.push(std::make_unique<int>(7));
+	std::unique_ptr<int> value;
+	CHECK(queue.pop(value));
+	CHECK(value && (*value == 7));
+}
+
+static void check_producers()
+{
+	streamdeck::mpsc_queue<uint64_t> queue;
+	std::atomic<int>                 running{PRODUCERS};
+	std::vector<std::thread>         producers;
+	for (uint64_t producer = 0; producer < PRODUCERS; producer++) {
+		producers.emplace_back([&queue, &running, producer]() {
+			for (uint64_t idx = 0; idx < PER_PRODUCER; idx++) {
+				queue.push((producer << 32) | idx);
+			}
+			running--;
+		});
+	}
+
+	// Values of each producer arrive in the order they were pushed, and nothing is lost or duplicated.
+	std::vector<uint64_t> next(PRODUCERS, 0);
+	size_t                received = 0;
+	bool                  ordered  = true;
+	uint64_t              value    = 0;
+	while ((running > 0) || (received < (PRODUCERS * PER_PRODUCER))) {
+		if (!queue.pop(value)) {
+			std::this_thread::yield();
+			continue;
+		}
+		uint64_t producer = value >> 32;
+		if ((producer >= PRODUCERS) || ((value & 0xFFFFFFFFu) != next[producer])) {
+			ordered = false;
+			break;
+		}
+		next[producer]++;
+		received++;
+	}
+	for (auto& thread : producers) {
+		thread.join();
+	}
+
+	CHECK(ordered);
+	CHECK(received == (PRODUCERS * PER_PRODUCER));
+	CHECK(!queue.pop(value));
+}
+
+int main()
+{
+	check_order();
+	check_ownership();
+	check_producers();
+	return streamdeck::tools::check_result();
+}
@@ -0,0 +1,232 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+#include "check.hpp"
+#include "handlers/handler-params.hpp"
+#include "param-schema.hpp"
+
+namespace params = streamdeck::params;
+
+struct sample_params {
+	const nlohmann::json*      source;
+	std::optional<bool>        enabled;
+	const nlohmann::json*      volume;
+	std::optional<double>      balance;
+	std::optional<std::string> name;
+	std::optional<int64_t>     count;
+};
+
+static constexpr params::field<sample_params> sample_fields[] = {
+	params::value("source", params::STRING | params::ARRAY, &sample_params::source, "The source.").require(),
+	params::boolean("enabled", &sample_params::enabled, "Enabled or not."),
+	params::value("volume", params::NUMBER | params::OBJECT, &sample_params::volume, "The volume.")
+		.range(0., std::numeric_limits<double>::max()),
+	params::number("balance", &sample_params::balance, "The balance.").range(0., 1.),
+	params::string("name", &sample_params::name, "The name."),
+	params::integer("count", &sample_params::count, "The count."),
+};
+
+static const params::schema<sample_params> sample_schema(sample_fields);
+
+// The message of the invalid params error thrown by decode(), or an empty string if nothing was thrown.
+static std::string decode_error(const char* text)
+{
+	try {
+		sample_schema.decode(nlohmann::json::parse(text));
+	} catch (const streamdeck::jsonrpc::invalid_params_error& ex) {
+		return ex.what();
+	}
+	return "";
+}
+
+static bool fails_with(const char* text, const std::string& expected)
+{
+	auto message = decode_error(text);
+	if (message != expected) {
+		std::fprintf(stderr, "Decoding %s\n    expected '%s', got '%s'\n", text, expected.c_str(), message.c_str());
+		return false;
+	}
+	return true;
+}
+
+static void check_decode()
+{
+	auto json    = nlohmann::json::parse(
+		R"({"source":["a","b"],"enabled":true,"volume":{"db":-3},"balance":0.5,"name":"x","count":3,"other":1})");
+	auto decoded = sample_schema.decode(json);
+	CHECK(decoded.source == &json["source"]);
+	CHECK(decoded.enabled == true);
+	CHECK(decoded.volume && (*decoded.volume == nlohmann::json::parse(R"({"db":-3})")));
+	CHECK(decoded.balance == 0.5);
+	CHECK(decoded.name == std::string("x"));
+	CHECK(decoded.count == 3);
+
+	// Absent optional params stay empty.
+	json    = nlohmann::json::parse(R"({"source":"a"})");
+	decoded = sample_schema.decode(json);
+	CHECK(decoded.source && decoded.source->is_string());
+	CHECK(!decoded.enabled && !decoded.volume && !decoded.balance && !decoded.name && !decoded.count);
+
+	// Integers are numbers too, and bounds are inclusive.
+	json    = nlohmann::json::parse(R"({"source":"a","volume":0,"balance":1,"count":9223372036854775807})");
+	decoded = sample_schema.decode(json);
+	CHECK(decoded.volume && (*decoded.volume == 0));
+	CHECK(decoded.balance == 1.0);
+	CHECK(decoded.count == std::numeric_limits<int64_t>::max());
+}
+
+static void check_errors()
+{
+	CHECK(fails_with("null", "Method requires parameters."));
+	CHECK(fails_with("[1]", "Parameters must be an object."));
+	CHECK(fails_with(R"("source")", "Parameters must be an object."));
+	CHECK(fails_with(R"({})", "'source' must be present."));
+	CHECK(fails_with(R"({"enabled":true})", "'source' must be present."));
+	CHECK(fails_with(R"({"source":5})", "'source' must be a string or an array."));
+	CHECK(fails_with(R"({"source":null})", "'source' must be a string or an array."));
+	CHECK(fails_with(R"({"source":"a","enabled":1})", "'enabled' must be a Boolean."));
+	CHECK(fails_with(R"({"source":"a","count":1.5})", "'count' must be an integer."));
+	CHECK(fails_with(R"({"source":"a","name":["x"]})", "'name' must be a string."));
+	CHECK(fails_with(R"({"source":"a","volume":-1})", "'volume' can't be lower than 0."));
+	CHECK(fails_with(R"({"source":"a","balance":2})", "'balance' can't be lower than 0 or higher than 1."));
+	CHECK(fails_with(R"({"source":"a","count":18446744073709551615})", "'count' can't be higher than 9.22337e+18."));
+
+	// Invalid params are reported before missing ones.
+	CHECK(fails_with(R"({"name":1})", "'name' must be a string."));
+}
+
+static void check_describe()
+{
+	auto infos = sample_schema.describe();
+	CHECK(infos.size() == 6);
+	CHECK(params::type_names(params::STRING) == "a string");
+	CHECK(params::type_names(params::STRING | params::ARRAY) == "a string or an array");
+	CHECK(params::type_names(params::BOOLEAN | params::NUMBER | params::NUL) == "a Boolean, a number or null");
+
+	CHECK(params::to_markdown(infos)
+		  == "##### Parameters\n"
+			 "An object containing:\n"
+			 "\n"
+			 "- <small>String|Array</small> `source`\n"
+			 "  The source.\n"
+			 "- <small>Boolean</small> `enabled` *(Optional)*\n"
+			 "  Enabled or not.\n"
+			 "- <small>Number|Object</small> `volume` *(Optional)*\n"
+			 "  The volume. At least 0.\n"
+			 "- <small>Number</small> `balance` *(Optional)*\n"
+			 "  The balance. From 0 to 1.\n"
+			 "- <small>String</small> `name` *(Optional)*\n"
+			 "  The name.\n"
+			 "- <small>Integer</small> `count` *(Optional)*\n"
+			 "  The count.\n");
+
+	CHECK(params::to_json(infos).dump()
+		  == R"([{"description":"The source.","name":"source","required":true,"types":["string","array"]},)"
+			 R"({"description":"Enabled or not.","name":"enabled","required":false,"types":["boolean"]},)"
+			 R"({"description":"The volume.","minimum":0.0,"name":"volume","required":false,)"
+			 R"("types":["number","object"]},)"
+			 R"({"description":"The balance.","maximum":1.0,"minimum":0.0,"name":"balance","required":false,)"
+			 R"("types":["number"]},)"
+			 R"({"description":"The name.","name":"name","required":false,"types":["string"]},)"
+			 R"({"description":"The count.","name":"count","required":false,"types":["integer"]}])");
+}
+
+static void check_bind()
+{
+	// Handlers only run with valid params, and see them borrowed from the request.
+	size_t calls    = 0;
+	auto   function = sample_schema.bind([&calls](const sample_params& decoded,
+											 std::shared_ptr<streamdeck::jsonrpc::request>  req,
+											 std::shared_ptr<streamdeck::jsonrpc::response> res) {
+		calls++;
+		CHECK(decoded.source == &req->get_params()["source"]);
+		CHECK(res != nullptr);
+	});
+
+	auto req = std::make_shared<streamdeck::jsonrpc::request>();
+	auto res = std::make_shared<streamdeck::jsonrpc::response>();
+	req->set_method("obs.sample");
+	req->set_params(nlohmann::json::parse(R"({"source":"a"})"));
+	function(req, res);
+	CHECK(calls == 1);
+
+	req->set_params(nlohmann::json::parse(R"({"source":1})"));
+	CHECK_THROWS(function(req, res), streamdeck::jsonrpc::invalid_params_error);
+	CHECK(calls == 1);
+
+	auto async = sample_schema.bind_async(
+		[&calls](const sample_params& decoded, std::weak_ptr<void>, std::shared_ptr<streamdeck::jsonrpc::request>) {
+			calls++;
+			CHECK(decoded.name == std::string("x"));
+		});
+	req->set_params(nlohmann::json::parse(R"({"source":"a","name":"x"})"));
+	async(std::weak_ptr<void>(), req);
+	CHECK(calls == 2);
+
+	req->clear_params();
+	CHECK_THROWS(async(std::weak_ptr<void>(), req), streamdeck::jsonrpc::invalid_params_error);
+	CHECK(calls == 2);
+}
+
+static void check_handler_params()
+{
+	namespace handlers = streamdeck::handlers;
+
+	auto json  = nlohmann::json::parse(R"({"source":["Scene","Filter"],"volume":0.5,"muted":true})");
+	auto state = handlers::source_state_method.get_schema().decode(json);
+	CHECK(state.source && state.source->is_array());
+	CHECK(state.volume && (*state.volume == 0.5));
+	CHECK(state.muted == true);
+	CHECK(!state.enabled && !state.balance);
+
+	json        = nlohmann::json::parse(R"({"session":"abc","seq":42})");
+	auto resume = handlers::session_resume_method.get_schema().decode(json);
+	CHECK(resume.session == std::string("abc"));
+	CHECK(resume.seq == 42);
+
+	json = nlohmann::json::parse(R"({"session":"abc","seq":-1})");
+	CHECK_THROWS(handlers::session_resume_method.get_schema().decode(json), streamdeck::jsonrpc::invalid_params_error);
+	CHECK_THROWS(handlers::watch_method.get_schema().decode(nlohmann::json()),
+				 streamdeck::jsonrpc::invalid_params_error);
+
+	// Every method is listed once, with described and uniquely named params.
+	std::set<std::string> methods;
+	bool                  complete = true;
+	for (auto const& method : params::declared_methods()) {
+		complete = complete && methods.insert(method.first).second && !method.second.empty();
+		std::set<std::string> names;
+		for (auto const& info : method.second) {
+			complete = complete && names.insert(info.name).second && !info.description.empty() && (info.types != 0);
+		}
+	}
+	CHECK(complete);
+	CHECK(methods.count("obs.source.state") == 1);
+	CHECK(methods.count("obs.unwatch") == 1);
+}
+
+int main()
+{
+	check_decode();
+	check_errors();
+	check_describe();
+	check_bind();
+	check_handler_params();
+	return streamdeck::tools::check_result();
+}
@@ -0,0 +1,143 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstdio>
+#include <string>
+#include "check.hpp"
+#include "handlers/source-metadata.hpp"
+
+// Same bits and names as in handler-obs-source.cpp, with the values from obs-source.h.
+static const streamdeck::handlers::flag_names_t output_flag_names = {
+	{1 << 0, "video"},
+	{1 << 1, "audio"},
+	{1 << 2, "async"},
+	{1 << 3, "custom_draw"},
+	{1 << 5, "interaction"},
+	{1 << 6, "composite"},
+	{1 << 7, "no_duplicate"},
+	{1 << 8, "deprecated"},
+	{1 << 9, "no_monitor"},
+	{1 << 10, "disabled"},
+	{1 << 11, "auto_monitor"},
+	{1 << 12, "submix"},
+	{1 << 13, "controllable_media"},
+};
+static const streamdeck::handlers::flag_names_t flag_names = {
+	{1 << 0, "unused_1"},
+	{1 << 1, "force_mono"},
+};
+
+static bool dumps_to(const nlohmann::json& value, const std::string& expected)
+{
+	auto result = value.dump();
+	if (result != expected) {
+		std::fprintf(stderr, "Expected %s\n     got %s\n", expected.c_str(), result.c_str());
+		return false;
+	}
+	return true;
+}
+
+static void check_source()
+{
+	streamdeck::handlers::source_metadata source;
+	source.id                = "ffmpeg_source";
+	source.id_unversioned    = "ffmpeg_source";
+	source.name              = "Intro \"Video\"";
+	source.type              = "input";
+	source.enabled           = true;
+	source.active            = true;
+	source.visible           = false;
+	source.output_flags      = (1 << 0) | (1 << 1) | (1 << 2) | (1 << 13);
+	source.flags             = 1 << 1;
+	source.width             = 1920;
+	source.height            = 1080;
+	source.base_width        = 3840;
+	source.base_height       = 2160;
+	source.audio.layout      = "2.0";
+	source.audio.muted       = false;
+	source.audio.volume      = 0.3f;
+	source.audio.balance     = 0.5f;
+	source.audio.sync_offset = -250000000;
+	source.audio.mixers      = 0x3F;
+	source.media.status      = "playing";
+	source.media.time        = 12345;
+	source.media.duration    = 60000;
+
+	CHECK(dumps_to(source.to_json(output_flag_names, flag_names),
+				   R"({"active":true,)"
+				   R"("audio":{"balance":0.5,"layout":"2.0","mixers":63,"muted":false,"sync_offset":-250000000,)"
+				   R"("volume":0.30000001192092896},)"
+				   R"("enabled":true,)"
+				   R"("flags":{"force_mono":true,"unused_1":false},)"
+				   R"("id":"ffmpeg_source","id_unversioned":"ffmpeg_source",)"
+				   R"("media":{"status":"playing","time":[12345,60000]},)"
+				   R"("name":"Intro \"Video\"",)"
+				   R"("output_flags":{"async":true,"audio":true,"auto_monitor":false,"composite":false,)"
+				   R"("controllable_media":true,"custom_draw":false,"deprecated":false,"disabled":false,)"
+				   R"("interaction":false,"no_duplicate":false,"no_monitor":false,"submix":false,"video":true},)"
+				   R"("outputflags":{"async":true,"audio":true,"auto_monitor":false,"composite":false,)"
+				   R"("controllable_media":true,"custom_draw":false,"deprecated":false,"disabled":false,)"
+				   R"("interaction":false,"no_duplicate":false,"no_monitor":false,"submix":false,"video":true},)"
+				   R"("size":[1920,1080,3840,2160],)"
+				   R"("type":"input","visible":false})"));
+}
+
+static void check_unknown()
+{
+	// Unknown types, layouts and media states are null, missing strings are empty.
+	streamdeck::handlers::source_metadata source;
+	CHECK(dumps_to(source.to_json(output_flag_names, flag_names),
+				   R"({"active":false,)"
+				   R"("audio":{"balance":0.0,"layout":null,"mixers":0,"muted":false,"sync_offset":0,"volume":0.0},)"
+				   R"("enabled":false,)"
+				   R"("flags":{"force_mono":false,"unused_1":false},)"
+				   R"("id":"","id_unversioned":"",)"
+				   R"("media":{"status":null,"time":[0,0]},)"
+				   R"("name":"",)"
+				   R"("output_flags":{"async":false,"audio":false,"auto_monitor":false,"composite":false,)"
+				   R"("controllable_media":false,"custom_draw":false,"deprecated":false,"disabled":false,)"
+				   R"("interaction":false,"no_duplicate":false,"no_monitor":false,"submix":false,"video":false},)"
+				   R"("outputflags":{"async":false,"audio":false,"auto_monitor":false,"composite":false,)"
+				   R"("controllable_media":false,"custom_draw":false,"deprecated":false,"disabled":false,)"
+				   R"("interaction":false,"no_duplicate":false,"no_monitor":false,"submix":false,"video":false},)"
+				   R"("size":[0,0,0,0],)"
+				   R"("type":null,"visible":false})"));
+}
+
+static void check_media()
+{
+	streamdeck::handlers::source_media_metadata media;
+	media.status   = "ended";
+	media.time     = -1;
+	media.duration = -1;
+	CHECK(dumps_to(media.to_json(), R"({"status":"ended","time":[-1,-1]})"));
+}
+
+static void check_flags()
+{
+	// Bits without a name are left out.
+	CHECK(dumps_to(streamdeck::handlers::build_flags_metadata(0xFFFFFFFF, flag_names),
+				   R"({"force_mono":true,"unused_1":true})"));
+	CHECK(dumps_to(streamdeck::handlers::build_flags_metadata(1 << 1, {}), R"({})"));
+}
+
+int main()
+{
+	check_source();
+	check_unknown();
+	check_media();
+	check_flags();
+	return streamdeck::tools::check_result();
+}
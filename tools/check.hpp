@@ -0,0 +1,75 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Helpers shared by the checks and benchmarks in this directory. Checks are plain executables which keep going after a
+// failed CHECK() and return check_result() from main(), so that ctest reports every failure at once.
+
+namespace streamdeck {
+	namespace tools {
+		inline int failures = 0;
+
+		inline int check_result()
+		{
+			if (failures > 0) {
+				std::fprintf(stderr, "%d check(s) failed.\n", failures);
+				return EXIT_FAILURE;
+			}
+			return EXIT_SUCCESS;
+		}
+
+		// Nanoseconds per iteration of func(), after a warm-up round.
+		template<typename F>
+		double time_per_iteration(size_t iterations, F&& func)
+		{
+			for (size_t idx = 0; idx < (iterations / 10); idx++) {
+				func();
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			for (size_t idx = 0; idx < iterations; idx++) {
+				func();
+			}
+			auto elapsed = std::chrono::steady_clock::now() - start;
+			return double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / double(iterations);
+		}
+	} // namespace tools
+} // namespace streamdeck
+
+#define CHECK(EXPR)                                                                     \
+	do {                                                                                \
+		if (!(EXPR)) {                                                                  \
+			std::fprintf(stderr, "%s:%d: Check failed: %s\n", __FILE__, __LINE__, #EXPR); \
+			streamdeck::tools::failures++;                                              \
+		}                                                                               \
+	} while (false)
+
+#define CHECK_THROWS(EXPR, TYPE)                                                                    \
+	do {                                                                                            \
+		bool thrown = false;                                                                        \
+		try {                                                                                       \
+			EXPR;                                                                                   \
+		} catch (TYPE const&) {                                                                     \
+			thrown = true;                                                                          \
+		}                                                                                           \
+		if (!thrown) {                                                                              \
+			std::fprintf(stderr, "%s:%d: Expected %s from: %s\n", __FILE__, __LINE__, #TYPE, #EXPR); \
+			streamdeck::tools::failures++;                                                          \
+		}                                                                                           \
+	} while (false)
@@ -0,0 +1,71 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Writes docs/params.md from the parameter schemas in handler-params.hpp.
+//
+//   generate-params-docs <path>          Write the documentation to <path>.
+//   generate-params-docs --check <path>  Fail if <path> isn't up to date.
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "handlers/handler-params.hpp"
+#include "param-schema.hpp"
+
+static std::string generate()
+{
+	std::string result = "# Declared Parameters\n"
+						 "Generated by `tools/generate-params-docs` from `source/handlers/handler-params.hpp`, do not "
+						 "edit by hand.\n"
+						 "\n"
+						 "These methods check their parameters before doing anything, and answer mistakes with error "
+						 "code `-32602`. The same descriptions are returned at runtime by `obs.system.methods`.\n";
+	for (auto const& method : streamdeck::params::declared_methods()) {
+		result += "\n### " + method.first + "\n";
+		result += streamdeck::params::to_markdown(method.second);
+	}
+	return result;
+}
+
+int main(int argc, const char* argv[])
+{
+	bool check = (argc == 3) && (std::strcmp(argv[1], "--check") == 0);
+	if ((argc != 2) && !check) {
+		std::fprintf(stderr, "Usage: %s [--check] <path>\n", argv[0]);
+		return 2;
+	}
+	const char* path = argv[argc - 1];
+	std::string docs = generate();
+
+	if (check) {
+		std::ifstream file(path, std::ios::binary);
+		std::string   current((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if (current != docs) {
+			std::fprintf(stderr, "%s is out of date, regenerate it with: generate-params-docs %s\n", path, path);
+			return 1;
+		}
+		return 0;
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file << docs;
+	if (!file) {
+		std::fprintf(stderr, "Failed to write %s.\n", path);
+		return 1;
+	}
+	return 0;
+}
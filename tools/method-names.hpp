@@ -0,0 +1,84 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+#include <cstddef>
+
+// A fixed sample of method names, copied from the handlers at one point in time, in the order they registered them.
+// It is not the live set and isn't kept in sync with the registrations, which need OBS Studio to run. It only gives
+// the dispatch table a realistic number and shape of keys to work with.
+
+namespace streamdeck {
+	namespace tools {
+		inline const char* const method_names[] = {
+			"obs.frontend.streaming.start",
+			"obs.frontend.streaming.stop",
+			"obs.frontend.streaming.active",
+			"obs.frontend.recording.start",
+			"obs.frontend.recording.stop",
+			"obs.frontend.recording.active",
+			"obs.frontend.recording.pause",
+			"obs.frontend.recording.unpause",
+			"obs.frontend.recording.paused",
+			"obs.frontend.replaybuffer.enabled",
+			"obs.frontend.replaybuffer.start",
+			"obs.frontend.replaybuffer.save",
+			"obs.frontend.replaybuffer.stop",
+			"obs.frontend.replaybuffer.active",
+			"obs.frontend.studiomode",
+			"obs.frontend.studiomode.enable",
+			"obs.frontend.studiomode.disable",
+			"obs.frontend.studiomode.active",
+			"obs.frontend.virtualcam",
+			"obs.frontend.virtualcam.start",
+			"obs.frontend.virtualcam.stop",
+			"obs.frontend.virtualcam.active",
+			"obs.frontend.transition_studio",
+			"obs.frontend.scenecollection",
+			"obs.frontend.scenecollection.list",
+			"obs.frontend.profile",
+			"obs.frontend.profile.list",
+			"obs.frontend.scene",
+			"obs.frontend.scene.list",
+			"obs.frontend.transition",
+			"obs.frontend.transition.list",
+			"obs.frontend.screenshot",
+			"obs.frontend.stats",
+			"obs.frontend.tbar",
+			"obs.frontend.recording.addchapter",
+			"obs.frontend.output.get",
+			"obs.scene.items",
+			"obs.scene.item.visible",
+			"obs.source.enumerate",
+			"obs.source.state",
+			"obs.source.filters",
+			"obs.source.settings",
+			"obs.source.media",
+			"obs.source.properties",
+			"obs.source.icons",
+			"ping",
+			"version",
+			"obs.subscribe",
+			"obs.unsubscribe",
+			"obs.system.metrics",
+			"obs.system.methods",
+			"obs.session.resume",
+			"obs.watch",
+			"obs.unwatch",
+		};
+
+		inline constexpr size_t method_count = sizeof(method_names) / sizeof(method_names[0]);
+	} // namespace tools
+} // namespace streamdeck
@@ -0,0 +1,249 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Runs the real server in-process, with WebSocket clients talking to it over loopback. Used by the benchmarks which
+// need the whole path through asio and websocketpp, and only built along with the plugin.
+
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "server.hpp"
+
+#include <nlohmann/json.hpp>
+#include <obs.h>
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4005 4244 4267)
+#endif
+#include <websocketpp/config/asio_no_tls_client.hpp>
+#include <websocketpp/client.hpp>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+namespace streamdeck {
+	namespace tools {
+		// The ports the server tries to listen on, in the same order as WEBSOCKET_PORTS in server.cpp.
+		static const unsigned short server_ports[] = {28186, 39726, 34247, 42206, 38535, 40829, 40624};
+
+		// libobs without video, modules or a frontend, which is all the server needs. The server logs every
+		// connection to std::cout through websocketpp, which is silenced for as long as this lives.
+		class obs_scope {
+			std::streambuf* _cout;
+
+			public:
+			obs_scope() : _cout(std::cout.rdbuf(nullptr))
+			{
+				obs_startup("en-US", nullptr, nullptr);
+			}
+
+			~obs_scope()
+			{
+				obs_shutdown();
+				std::cout.rdbuf(_cout);
+			}
+		};
+
+		// Register a method that answers with a token unique to this process, so that clients can tell our server
+		// apart from one in a running OBS Studio.
+		inline std::string register_identity(streamdeck::server& server)
+		{
+			std::random_device rd;
+			std::string        token = std::to_string(rd()) + "-" + std::to_string(rd());
+			server.handle_sync("bench.identify", [token](std::shared_ptr<streamdeck::jsonrpc::request>,
+														std::shared_ptr<streamdeck::jsonrpc::response> res) {
+				res->set_result(token);
+			});
+			return token;
+		}
+
+		// JSON-RPC client on its own io_context and thread. Calls block until answered, notifications are handed to
+		// the handler on the client thread.
+		class ws_client {
+			typedef websocketpp::client<websocketpp::config::asio_client> client_t;
+			typedef std::function<void(const nlohmann::json&)>           notification_handler_t;
+
+			client_t                          _client;
+			std::thread                       _thread;
+			std::string                       _protocol;
+			notification_handler_t            _on_notification;
+			std::mutex                        _lock;
+			std::condition_variable           _signal;
+			websocketpp::connection_hdl       _handle;
+			int                               _state; // 0 while connecting, 1 once open, -1 if it failed or closed.
+			int64_t                           _next_id;
+			std::map<int64_t, nlohmann::json> _responses;
+
+			void on_message(websocketpp::connection_hdl, client_t::message_ptr msg)
+			{
+				nlohmann::json document;
+				if (msg->get_opcode() == websocketpp::frame::opcode::binary) {
+					document = nlohmann::json::from_msgpack(msg->get_payload());
+				} else {
+					document = nlohmann::json::parse(msg->get_payload());
+				}
+
+				auto id = document.find("id");
+				if ((id != document.end()) && id->is_number_integer()) {
+					std::unique_lock<std::mutex> lock(_lock);
+					_responses[id->get<int64_t>()] = std::move(document);
+					_signal.notify_all();
+				} else if (_on_notification) {
+					_on_notification(document);
+				}
+			}
+
+			void set_state(int state)
+			{
+				std::unique_lock<std::mutex> lock(_lock);
+				_state = state;
+				_signal.notify_all();
+			}
+
+			public:
+			// Protocol is either "streamdeck-obs" or "streamdeck-obs+msgpack".
+			ws_client(std::string protocol = "streamdeck-obs", notification_handler_t on_notification = nullptr)
+				: _client(), _thread(), _protocol(std::move(protocol)), _on_notification(std::move(on_notification)),
+				  _state(-1), _next_id(1)
+			{
+				_client.clear_access_channels(websocketpp::log::alevel::all);
+				_client.clear_error_channels(websocketpp::log::elevel::all);
+				_client.init_asio();
+				_client.start_perpetual();
+				_client.set_open_handler([this](websocketpp::connection_hdl) { set_state(1); });
+				_client.set_fail_handler([this](websocketpp::connection_hdl) { set_state(-1); });
+				_client.set_close_handler([this](websocketpp::connection_hdl) { set_state(-1); });
+				_client.set_message_handler(
+					std::bind(&ws_client::on_message, this, std::placeholders::_1, std::placeholders::_2));
+				_thread = std::thread([this]() { _client.run(); });
+			}
+
+			~ws_client()
+			{
+				close();
+				_client.stop_perpetual();
+				_client.stop();
+				_thread.join();
+			}
+
+			bool connect(unsigned short port)
+			{
+				websocketpp::lib::error_code ec;
+				auto con = _client.get_connection("ws://127.0.0.1:" + std::to_string(port), ec);
+				if (ec) {
+					return false;
+				}
+				con->add_subprotocol(_protocol);
+
+				std::unique_lock<std::mutex> lock(_lock);
+				_state  = 0;
+				_handle = con->get_handle();
+				_client.connect(con);
+				_signal.wait(lock, [this]() { return _state != 0; });
+				return _state == 1;
+			}
+
+			void close()
+			{
+				websocketpp::lib::error_code ec;
+				std::unique_lock<std::mutex> lock(_lock);
+				if (_state != 1) {
+					return;
+				}
+				_client.close(_handle, websocketpp::close::status::normal, "", ec);
+				_signal.wait_for(lock, std::chrono::seconds(1), [this]() { return _state != 1; });
+			}
+
+			// The whole response, or null if there was none within the timeout.
+			nlohmann::json call(const std::string& method, nlohmann::json params = nullptr,
+								std::chrono::milliseconds timeout = std::chrono::milliseconds(1000))
+			{
+				int64_t        id;
+				nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", method}};
+				{
+					std::unique_lock<std::mutex> lock(_lock);
+					id = _next_id++;
+				}
+				request["id"] = id;
+				if (!params.is_null()) {
+					request["params"] = std::move(params);
+				}
+
+				websocketpp::lib::error_code ec;
+				if (_protocol == "streamdeck-obs+msgpack") {
+					auto payload = nlohmann::json::to_msgpack(request);
+					_client.send(_handle, payload.data(), payload.size(), websocketpp::frame::opcode::binary, ec);
+				} else {
+					_client.send(_handle, request.dump(), websocketpp::frame::opcode::text, ec);
+				}
+				if (ec) {
+					return nullptr;
+				}
+
+				std::unique_lock<std::mutex> lock(_lock);
+				if (!_signal.wait_for(lock, timeout, [this, id]() { return _responses.count(id) > 0; })) {
+					return nullptr;
+				}
+				auto response = std::move(_responses[id]);
+				_responses.erase(id);
+				return response;
+			}
+		};
+
+		// Connect to the port the server listens on, which is the first of server_ports nothing else had taken.
+		inline unsigned short connect_to_server(ws_client& client, const std::string& token)
+		{
+			// The server starts listening on its worker thread, so it may not be there right away.
+			auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+			while (std::chrono::steady_clock::now() < deadline) {
+				for (auto port : server_ports) {
+					if (!client.connect(port)) {
+						continue;
+					}
+					auto response = client.call("bench.identify");
+					if (response.is_object() && (response.value("result", nlohmann::json()) == token)) {
+						return port;
+					}
+					client.close();
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			}
+			return 0;
+		}
+
+		// Percentiles of the given latencies, in microseconds.
+		inline void print_latencies(const char* name, std::vector<double> latencies)
+		{
+			if (latencies.empty()) {
+				return;
+			}
+			std::sort(latencies.begin(), latencies.end());
+			auto at = [&latencies](double p) { return latencies[size_t(p * double(latencies.size() - 1))]; };
+			std::printf("%-24s p50 %8.1f us, p90 %8.1f us, p99 %8.1f us, max %8.1f us\n", name, at(0.5), at(0.9),
+						at(0.99), latencies.back());
+		}
+	} // namespace tools
+} // namespace streamdeck
@@ -0,0 +1,45 @@
+// Copyright (C) 2022, Corsair Memory Inc. All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// What the server needs from module.cpp, for running it outside of OBS Studio. Without a loaded module,
+// obs_module_config_path() returns nothing, so neither the discovery file nor the local socket is created.
+
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include "module.hpp"
+
+#include <obs-module.h>
+
+OBS_DECLARE_MODULE()
+
+std::string streamdeck::get_translated_text(const std::string& text)
+{
+	return text;
+}
+
+void streamdeck::message(streamdeck::log_level level, const char* format, ...)
+{
+	// Anything below warnings would only disturb the measurements.
+	if (level > streamdeck::log_level::LOG_WARNING) {
+		return;
+	}
+
+	va_list va;
+	va_start(va, format);
+	std::vfprintf(stderr, format, va);
+	va_end(va);
+	std::fputc('\n', stderr);
+}